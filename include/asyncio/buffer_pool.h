@@ -0,0 +1,114 @@
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+#include <asyncio/asyncio_ns.h>
+#include <asyncio/noncopyable.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+ASYNCIO_NS_BEGIN
+
+class BufferPool;
+
+namespace detail {
+inline constexpr size_t cache_line_size = 64;
+
+// Header in front of every block's data, padded to a cache line so that the data is cache line aligned too.
+struct alignas(cache_line_size) BufferBlock {
+    BufferPool* pool;
+    BufferBlock* next_free;
+    size_t capacity;
+    uint32_t refs;
+    bool pooled; // else a one-off allocation, for sizes larger than the pool's blocks
+    char* data() { return reinterpret_cast<char*>(this + 1); }
+};
+} // namespace detail
+
+// A reference counted buffer from a BufferPool, that goes back to the pool when the last lease of it goes away.
+// Satisfies concepts::MutableByteBuf, so it can be used as the buffer for Stream::read() & Stream::write():
+//
+//     auto data = co_await stream.read<BufferLease>(4096);
+//     co_await stream.write(data);
+//
+// Leases are tied to the thread of their pool (the reference count isn't atomic).
+class BufferLease {
+public:
+    using value_type = char;
+
+    BufferLease() = default;
+    // A buffer of `size` bytes from this thread's pool. The contents are *not* initialized: `fill` is only there so
+    // that this has the same shape as the containers' (count, value) constructor.
+    explicit BufferLease(size_t size, char fill = {});
+    BufferLease(BufferLease&& other) noexcept
+        : block_(std::exchange(other.block_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+    BufferLease& operator=(BufferLease&& other) noexcept {
+        if (this != &other) {
+            reset();
+            block_ = std::exchange(other.block_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+    ~BufferLease() { reset(); }
+
+    char* data() { return block_ ? block_->data() : nullptr; }
+    const char* data() const { return block_ ? block_->data() : nullptr; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return block_ ? block_->capacity : 0; }
+    // Throws std::length_error if `size` is larger than the capacity.
+    void resize(size_t size);
+
+    // Another lease of the same buffer, e.g. to keep the data around while it's also being written elsewhere.
+    BufferLease share() const;
+    size_t use_count() const { return block_ ? block_->refs : 0; }
+    // Drops this lease; the buffer goes back to the pool if it was the last one.
+    void reset();
+
+private:
+    friend class BufferPool;
+    BufferLease(detail::BufferBlock* block, size_t size): block_(block), size_(size) {}
+
+    detail::BufferBlock* block_{};
+    size_t size_{0};
+};
+
+// Hands out fixed size, cache line aligned blocks carved out of larger slabs, and takes them back for reuse, so that
+// reading & writing in a loop doesn't allocate once the pool is warm. Requests larger than the block size get a
+// one-off allocation instead. The pool must outlive its leases.
+class BufferPool : NonCopyable {
+public:
+    static constexpr size_t default_block_size = 16 * 1024;
+    static constexpr size_t default_blocks_per_slab = 64;
+
+    explicit BufferPool(size_t block_size = default_block_size, size_t blocks_per_slab = default_blocks_per_slab);
+    ~BufferPool();
+
+    BufferLease acquire(size_t size);
+
+    size_t block_size() const { return block_size_; }
+    size_t slab_count() const { return slabs_.size(); }
+    size_t free_count() const { return free_count_; }
+    size_t in_use() const { return in_use_; } // blocks lent out, including one-off allocations
+
+private:
+    friend class BufferLease;
+    void give_back(detail::BufferBlock* block);
+
+    size_t block_size_;
+    size_t blocks_per_slab_;
+    std::vector<std::byte*> slabs_;
+    detail::BufferBlock* free_{};
+    size_t free_count_{0};
+    size_t in_use_{0};
+};
+
+// Returns the buffer pool for this thread, like get_event_loop().
+BufferPool& get_buffer_pool();
+
+ASYNCIO_NS_END
@@ -0,0 +1,89 @@
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+#include <asyncio/asyncio_ns.h>
+#include <asyncio/concept/bytebuf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <sys/uio.h>
+
+ASYNCIO_NS_BEGIN
+
+// Picks the size of the next read from how much the previous reads returned, like netty's
+// AdaptiveRecvByteBufAllocator: grows quickly while reads fill what they're given, and shrinks one step at a time
+// after two reads in a row would have fit in the next smaller size.
+class AdaptiveReadSize {
+public:
+    static constexpr size_t min_size = 512;
+    static constexpr size_t initial_size = 4096;
+    static constexpr size_t max_size = 1024 * 1024;
+
+    size_t next() const { return min_size << index_; }
+    void record(size_t nread);
+
+private:
+    static constexpr unsigned max_index = 11; // min_size << 11 == max_size
+    unsigned index_{3};                       // min_size << 3 == initial_size
+    bool shrink_pending_{false};
+};
+
+// A byte buffer made of a chain of segments, for reading data of unknown length without reallocating and copying
+// it over and over. The segments come from a per-thread pool, and go back there when the buffer is cleared or
+// destroyed. The data is only made contiguous when asked for, with flatten().
+class ChunkedBuffer {
+public:
+    ChunkedBuffer() = default;
+    ChunkedBuffer(ChunkedBuffer&& other) noexcept;
+    ChunkedBuffer& operator=(ChunkedBuffer&& other) noexcept;
+    ~ChunkedBuffer() { clear(); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t segment_count() const { return segments_.size(); }
+    std::span<const char> segment(size_t i) const { return {segments_[i].data, segments_[i].size}; }
+
+    void append(std::span<const char> data);
+    // Gives all segments back to the pool.
+    void clear();
+
+    // Copies up to out.size() bytes into `out`, returns how many were copied.
+    size_t copy_to(std::span<char> out) const;
+    template<concepts::MutableByteBuf BUF = std::vector<char>>
+    BUF flatten() const {
+        BUF result(size_, typename BUF::value_type{});
+        copy_to(std::span{reinterpret_cast<char*>(result.data()), result.size()});
+        return result;
+    }
+
+    // For reading into the buffer with readv(): prepare() returns the space for the next read, sized by the
+    // AdaptiveReadSize, and commit() appends the `nread` bytes that were actually read into it.
+    std::span<const iovec> prepare();
+    void commit(size_t nread);
+    const AdaptiveReadSize& read_size() const { return read_size_; }
+
+private:
+    struct Segment {
+        char* data;
+        size_t capacity;
+        size_t size;
+    };
+    static Segment acquire(size_t capacity);
+    static void release(const Segment& segment);
+
+    std::vector<Segment> segments_;
+    std::optional<Segment> spare_; // fresh segment handed out by prepare(), not holding any data yet
+    iovec iov_[2]{};
+    size_t iov_count_{0};
+    size_t tail_room_{0}; // room left in the last segment, as handed out by prepare()
+    size_t size_{0};
+    AdaptiveReadSize read_size_;
+};
+
+ASYNCIO_NS_END
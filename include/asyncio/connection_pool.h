@@ -0,0 +1,123 @@
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+#include <asyncio/asyncio_ns.h>
+#include <asyncio/handle.h>
+#include <asyncio/noncopyable.h>
+#include <asyncio/open_connection.h>
+#include <asyncio/schedule_task.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+ASYNCIO_NS_BEGIN
+
+struct ConnectionPoolOptions {
+    size_t max_per_key{16};    // connections per (host, port), lent out + idle + being opened
+    size_t min_idle_per_key{0}; // idle connections to keep warm, see ConnectionPool::warm_up
+    std::chrono::milliseconds idle_timeout{std::chrono::seconds(60)}; // idle connections older than this are closed
+    ConnectOptions connect{};
+};
+
+// Keeps idle outbound connections around for reuse, keyed by (host, port).
+//
+// acquire() lends out a connection as a Lease, which gives it back to the pool when it goes away. Idle connections
+// are checked for liveness before being lent out again; dead or expired ones are closed and replaced. When a key
+// is at `max_per_key`, acquire() waits until some connection is returned.
+//
+// The pool must outlive its leases, and must only be used from the thread of the EventLoop that created it.
+class ConnectionPool : NonCopyable {
+    using MSDuration = std::chrono::milliseconds;
+    struct Bucket;
+public:
+    struct Stats {
+        size_t hits{};         // acquired an idle connection
+        size_t misses{};       // acquired a newly opened connection
+        size_t waits{};        // had to wait for a connection to be returned
+        size_t dropped{};      // idle connections closed for being dead or expired
+        MSDuration total_wait{}; // time spent inside acquire(), over all acquires
+        MSDuration max_wait{};
+
+        double hit_rate() const { return hits + misses ? double(hits) / double(hits + misses) : 0.0; }
+    };
+
+    class Lease : NonCopyable {
+    public:
+        Lease(Lease&& other) noexcept
+            : pool_(std::exchange(other.pool_, nullptr)), bucket_(other.bucket_), stream_(std::move(other.stream_)) {}
+        ~Lease() { release(); }
+
+        Stream& operator*() { return *stream_; }
+        Stream* operator->() { return &*stream_; }
+
+        // The connection is in an unknown state (e.g. a protocol error), close it instead of giving it back.
+        void discard() { stream_.reset(); }
+        // Gives the connection back to the pool early.
+        void release();
+
+    private:
+        friend class ConnectionPool;
+        Lease(ConnectionPool& pool, Bucket& bucket, Stream stream)
+            : pool_(&pool), bucket_(&bucket) { stream_.emplace(std::move(stream)); }
+
+        ConnectionPool* pool_;
+        Bucket* bucket_;
+        std::optional<Stream> stream_;
+    };
+
+    explicit ConnectionPool(ConnectionPoolOptions options = {}): options_(std::move(options)) {}
+    ~ConnectionPool();
+
+    Task<Lease> acquire(std::string_view host, uint16_t port);
+
+    // Opens connections until (host, port) has at least `min_idle_per_key` idle ones. The pool also tops up in the
+    // background whenever a lease leaves fewer than that idle.
+    Task<> warm_up(std::string_view host, uint16_t port);
+
+    size_t idle_count(std::string_view host, uint16_t port) const;
+    size_t connection_count(std::string_view host, uint16_t port) const;
+    const Stats& stats() const { return stats_; }
+    const ConnectionPoolOptions& options() const { return options_; }
+
+private:
+    struct Idle {
+        Stream stream;
+        MSDuration since;
+    };
+    struct Bucket {
+        std::string host;
+        uint16_t port;
+        std::deque<Idle> idle;           // most recently returned at the back
+        size_t total{0};                 // idle + lent out + being opened
+        std::list<CoroHandle*> waiters;  // acquire()s waiting for a connection to be returned
+        bool warming{false};
+    };
+    struct WaitAwaiter;
+
+    Bucket& bucket(std::string_view host, uint16_t port);
+    const Bucket* find_bucket(std::string_view host, uint16_t port) const;
+    std::optional<Stream> take_idle(Bucket& b);
+    Task<Stream> open(Bucket& b);
+    void give_back(Bucket& b, std::optional<Stream> stream);
+    void wake_one(Bucket& b);
+    void record_wait(MSDuration waited);
+    void warm_up_in_background(Bucket& b);
+    Task<> warm_up(Bucket& b);
+
+    ConnectionPoolOptions options_;
+    Stats stats_;
+    std::unordered_map<std::string, Bucket> buckets_; // node based: Leases point into it
+    std::list<ScheduledTask<Task<>>> background_;      // declared last, so that these go away first
+};
+
+ASYNCIO_NS_END
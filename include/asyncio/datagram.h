@@ -0,0 +1,92 @@
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+#include <asyncio/asyncio_ns.h>
+#include <asyncio/buffer_pool.h>
+#include <asyncio/expected.h>
+#include <asyncio/noncopyable.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <sys/socket.h>
+
+ASYNCIO_NS_BEGIN
+
+// One UDP datagram and the address it came from, or goes to.
+struct Datagram {
+    BufferLease data;
+    sockaddr_storage addr{};
+    socklen_t addrlen{}; // 0 when sending: to the peer the endpoint is connected to
+    // With GSO/GRO (see DatagramOptions), `data` holds several datagrams of `segment_size` bytes each, the last one
+    // possibly shorter, sent or received in one go. 0 means `data` is a single datagram.
+    uint16_t segment_size{};
+};
+
+struct DatagramOptions {
+    // Most datagrams moved per recvmmsg() / sendmmsg() call.
+    size_t batch_size{64};
+    // Receive buffer per datagram, longer datagrams are truncated. 0 means the block size of this thread's
+    // BufferPool, which the buffers are borrowed from.
+    size_t max_datagram_size{0};
+    // UDP generic segmentation offload (Linux UDP_SEGMENT): datagrams sent with a `segment_size` are split up by the
+    // kernel (or the NIC), so a whole train of them costs one trip through the stack. The kernel takes at most 64
+    // segments, and 64KB, per Datagram. Without GSO, such Datagrams are sent as one message per segment.
+    bool gso{false};
+    // UDP generic receive offload (Linux UDP_GRO): the kernel may coalesce datagrams of one flow into one Datagram,
+    // with its `segment_size` set. Receive buffers should then be large enough for a train of them.
+    bool gro{false};
+    // SO_REUSEPORT, so that several endpoints (e.g. one per thread) can share a port.
+    bool reuse_port{false};
+};
+
+// A UDP socket. Datagrams move in batches, as many as are ready (up to the batch size) per system call.
+class DatagramEndpoint : NonCopyable {
+public:
+    explicit DatagramEndpoint(int fd, DatagramOptions options = {});
+    DatagramEndpoint(DatagramEndpoint&&);
+    ~DatagramEndpoint();
+
+    void close() { stream_.close(); }
+
+    // Waits for at least one datagram, then returns those already there, at most `max_count` (0: the batch size).
+    // They are received into a scratch buffer of the endpoint, reused from call to call, and each copied into a lease of
+    // its own size: a batch only borrows from the pool what it received.
+    Task<std::vector<Datagram>> recv_batch(size_t max_count = 0);
+    // Like `recv_batch()`, but errors are returned rather than thrown.
+    Task<Expected<std::vector<Datagram>>> try_recv_batch(size_t max_count = 0);
+
+    // Sends all of `datagrams`, waiting whenever the socket buffer is full. Returns how many were sent.
+    Task<size_t> send_batch(std::span<const Datagram> datagrams);
+    // Like `send_batch()`, but errors are returned rather than thrown.
+    Task<Expected<size_t>> try_send_batch(std::span<const Datagram> datagrams);
+
+    // Local address if `peer==false`, the address connected to if `peer==true`.
+    const sockaddr_storage& get_sock_info(bool peer = false) const { return stream_.get_sock_info(peer); }
+    uint16_t get_port(bool peer = false) const { return stream_.get_port(peer); }
+    int get_fd() const { return stream_.get_fd(); }
+    const DatagramOptions& options() const { return options_; }
+
+private:
+    struct RecvScratch;
+
+    Stream stream_; // owns the fd and its registration in the event loop
+    DatagramOptions options_;
+    std::unique_ptr<RecvScratch> scratch_; // allocated by the first recv_batch()
+};
+
+// A UDP endpoint bound to `host`:`port`, port 0 picks a free one. Receives from, and sends to, any address.
+Task<DatagramEndpoint> create_datagram_endpoint(std::string_view host, uint16_t port, DatagramOptions options = {});
+
+// A UDP endpoint connected to `host`:`port`: it only receives from there, and its Datagrams need no address to be sent.
+Task<DatagramEndpoint> connect_datagram_endpoint(std::string_view host, uint16_t port, DatagramOptions options = {});
+
+ASYNCIO_NS_END
@@ -12,9 +12,15 @@
 
 #include <algorithm>
 #include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <queue>
+#include <system_error>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 ASYNCIO_NS_BEGIN
 class EventLoop : private NonCopyable {
@@ -45,6 +51,9 @@ public:
         ready_.push({handle.get_handle_id(), &handle});
     }
 
+    // Fails with std::system_error if the fd can't be waited on: the selector's error if it can't watch it (a closed
+    // fd, a regular file with epoll), or device_or_resource_busy if something else (a Stream, add_reader(), another
+    // wait) is registered for it in that direction already.
     struct WaitEventAwaiter {
         bool await_ready() noexcept {
             bool ready = (event_.handle_info.handle == (const Handle*)&event_.handle_info.handle);
@@ -52,19 +61,32 @@ public:
             return ready;
         }
         template<typename Promise>
-        constexpr void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        constexpr bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            error_ = arm();
+            if (error_) { return false; } //< resume right away, to throw
             handle.promise().set_state(Handle::SUSPEND);
             event_.handle_info = {
                 .id = handle.promise().get_handle_id(),
                 .handle = &handle.promise() //< set callback
             };
+            return true;
+        }
+        void await_resume() {
+            event_.handle_info = { }; //< reset callback
+            if (error_) { throw std::system_error(std::exchange(error_, {})); }
+        }
+
+        // Registers with the selector ahead of the first wait, so that an event firing before then is kept as ready.
+        // Returns why it couldn't; waiting then fails with that error.
+        std::error_code arm() noexcept {
             if (! registered_) {
-                selector_.register_event(event_);
+                if (selector_.is_registered(event_.fd, event_.flags)) {
+                    return std::make_error_code(std::errc::device_or_resource_busy);
+                }
+                if (auto error = selector_.register_event(event_)) { return error; }
                 registered_ = true;
             }
-        }
-        void await_resume() noexcept {
-            event_.handle_info = { }; //< reset callback
+            return {};
         }
 
         void destroy() noexcept {
@@ -81,6 +103,7 @@ public:
         Selector& selector_;
         Event event_ {};
         bool registered_ { false };
+        std::error_code error_ {};
     };
 
     [[nodiscard]]
@@ -88,9 +111,63 @@ public:
         return WaitEventAwaiter{selector_, event};
     }
 
+    // For objects that keep their own Events registered across many waits instead of holding a WaitEventAwaiter
+    // (see Stream). The Event must stay where it is until it is removed again.
+    void register_event(const Event& event) { selector_.register_event(event); }
+    void remove_event(const Event& event) { selector_.remove_event(event); }
+
+    // Waits until a foreign fd (one no Stream owns) can be read from / written to without blocking, e.g. for the
+    // socket of a database driver in async mode. Registered only for the duration of the wait.
+    [[nodiscard]]
+    auto wait_readable(int fd) { return wait_event({.fd = fd, .flags = Event::Flags::EVENT_READ}); }
+    [[nodiscard]]
+    auto wait_writable(int fd) { return wait_event({.fd = fd, .flags = Event::Flags::EVENT_WRITE}); }
+
+    // Like python's `loop.add_reader()` / `loop.add_writer()`, for libraries that drive their own fds from callbacks
+    // (libcurl's multi interface, c-ares): `callback` is called from the loop whenever `fd` is readable (writable), as
+    // long as it is, until it is removed again. Adding another callback for the same fd and direction replaces the
+    // previous one. A reader and a writer on the same fd share its registration with the selector, but neither may be
+    // combined with a Stream, or another wait, on that fd and direction: adding one then throws
+    // std::system_error(device_or_resource_busy). Fds the selector can't watch (closed ones, regular files with epoll)
+    // throw the selector's error. While any callback is added, the loop keeps running (`run()` doesn't return).
+    // Callbacks may add and remove callbacks, including themselves.
+    void add_reader(int fd, std::function<void()> callback) { add_watcher(readers_, fd, Event::Flags::EVENT_READ, std::move(callback)); }
+    void add_writer(int fd, std::function<void()> callback) { add_watcher(writers_, fd, Event::Flags::EVENT_WRITE, std::move(callback)); }
+    // Return whether there was a callback for `fd` to remove.
+    bool remove_reader(int fd) { return remove_watcher(readers_, fd); }
+    bool remove_writer(int fd) { return remove_watcher(writers_, fd); }
+
     void run_until_complete();
 
+    // For embedding the loop in a main loop of its own (a game tick, a GUI, another reactor) rather than giving it a
+    // thread. poll() does one iteration: it waits up to `timeout` for fds to become ready (none, by default), then
+    // runs whatever is due. Returns the number of callbacks and coroutines it ran.
+    size_t poll(MSDuration timeout = MSDuration{0});
+    // Iterates for `duration`, whether or not there is anything to do, e.g. until the next frame is due.
+    void run_for(MSDuration duration);
+
+    // The selector's own fd (epoll or kqueue): it becomes readable when a registered fd is ready, so the outer
+    // poller can watch it and call poll() then. Ready coroutines and timers don't show up on it, so also wake up
+    // after `next_timeout()`.
+    int get_fd() const { return selector_.get_fd(); }
+    // How long the loop has nothing to do but wait for fds: zero if something is ready to run, the time until the
+    // next timer if there is one, or nullopt if only fds can make progress.
+    std::optional<MSDuration> next_timeout();
+
 private:
+    // An add_reader() / add_writer() callback. Its Event stays registered, so the selector reports it in every
+    // select() while the fd is ready.
+    struct FdWatcher : Handle {
+        FdWatcher(int fd, Event::Flags flags, std::function<void()> callback);
+        void run() override;
+        Event event;
+        std::function<void()> callback;
+        bool removed { false };
+    };
+    using FdWatchers = std::unordered_map<int, std::unique_ptr<FdWatcher>>;
+    void add_watcher(FdWatchers& watchers, int fd, Event::Flags flags, std::function<void()> callback);
+    bool remove_watcher(FdWatchers& watchers, int fd);
+
     bool is_stop() {
         return schedule_.empty() && ready_.empty() && selector_.is_stop();
     }
@@ -105,7 +182,7 @@ private:
         std::ranges::push_heap(schedule_, std::ranges::greater{}, &TimerHandle::first);
     }
 
-    void run_once();
+    size_t run_once(std::optional<MSDuration> max_wait = std::nullopt);
 
 private:
     MSDuration start_time_;
@@ -114,6 +191,10 @@ private:
     using TimerHandle = std::pair<MSDuration, HandleInfo>;
     std::vector<TimerHandle> schedule_; // min time heap
     std::unordered_set<HandleId> cancelled_;
+    FdWatchers readers_;
+    FdWatchers writers_;
+    // Removed watchers, which may still be queued in `ready_`; freed once run_once() is through with it.
+    std::vector<std::unique_ptr<FdWatcher>> removed_watchers_;
 };
 
 // Returns the event loop for this thread. These live in thread_local storage so each thread has a unique EventLoop.
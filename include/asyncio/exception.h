@@ -4,6 +4,7 @@
 
 #pragma once
 #include <asyncio/asyncio_ns.h>
+#include <cstddef>
 #include <exception>
 ASYNCIO_NS_BEGIN
 struct TimeoutError : std::exception {
@@ -18,4 +19,19 @@ struct InvalidFuture : std::exception {
     [[nodiscard]] const char* what() const noexcept override { return "future is invalid"; }
 };
 
+// EOF was reached before the requested bytes (or the delimiter) could be read; `partial` bytes were available.
+struct IncompleteReadError : std::exception {
+    IncompleteReadError(size_t partial, size_t expected): partial(partial), expected(expected) { }
+    [[nodiscard]] const char* what() const noexcept override { return "IncompleteReadError"; }
+    size_t partial;
+    size_t expected; // 0 if unknown, e.g. while looking for a delimiter
+};
+
+// The delimiter was not found within the reader's limit; the `consumed` bytes scanned are left in the buffer.
+struct LimitOverrunError : std::exception {
+    explicit LimitOverrunError(size_t consumed): consumed(consumed) { }
+    [[nodiscard]] const char* what() const noexcept override { return "LimitOverrunError"; }
+    size_t consumed;
+};
+
 ASYNCIO_NS_END
@@ -0,0 +1,70 @@
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+#include <asyncio/asyncio_ns.h>
+
+#include <system_error>
+#include <utility>
+#include <variant>
+
+ASYNCIO_NS_BEGIN
+
+// Either a value or the std::error_code of why there is none, for the try_* variants of APIs that otherwise throw
+// std::system_error. Errors that are routine under load (EOF, resets, timeouts, refused connections) come back as
+// values, so they cost no more than a successful call: no exception is thrown and no stack is unwound.
+template<typename T>
+class Expected {
+public:
+    Expected(T value) : result_(std::in_place_index<0>, std::move(value)) { }
+    Expected(std::error_code error) : result_(std::in_place_index<1>, error) { }
+
+    bool has_value() const noexcept { return result_.index() == 0; }
+    explicit operator bool() const noexcept { return has_value(); }
+
+    // Throws std::system_error if there is no value, like the throwing API would have.
+    T& value() & { check(); return std::get<0>(result_); }
+    const T& value() const & { check(); return std::get<0>(result_); }
+    T&& value() && { check(); return std::get<0>(std::move(result_)); }
+
+    T& operator*() & noexcept { return *std::get_if<0>(&result_); }
+    const T& operator*() const & noexcept { return *std::get_if<0>(&result_); }
+    T&& operator*() && noexcept { return std::move(*std::get_if<0>(&result_)); }
+    T* operator->() noexcept { return std::get_if<0>(&result_); }
+    const T* operator->() const noexcept { return std::get_if<0>(&result_); }
+
+    // The error, or an empty error_code if there is a value.
+    std::error_code error() const noexcept {
+        auto error = std::get_if<1>(&result_);
+        return error ? *error : std::error_code{};
+    }
+
+private:
+    void check() const {
+        if (! has_value()) [[unlikely]] { throw std::system_error(*std::get_if<1>(&result_)); }
+    }
+
+    std::variant<T, std::error_code> result_;
+};
+
+template<>
+class Expected<void> {
+public:
+    Expected() = default;
+    Expected(std::error_code error) : error_(error) { }
+
+    bool has_value() const noexcept { return ! error_; }
+    explicit operator bool() const noexcept { return has_value(); }
+
+    void value() const {
+        if (error_) [[unlikely]] { throw std::system_error(error_); }
+    }
+
+    std::error_code error() const noexcept { return error_; }
+
+private:
+    std::error_code error_;
+};
+
+ASYNCIO_NS_END
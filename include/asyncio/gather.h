@@ -44,19 +44,25 @@ private:
 
     template<size_t Idx, concepts::Awaitable Fut>
     Task<> collect_result(NoWaitAtInitialSuspend, Fut&& fut) {
+        // Once a task failed, its exception replaced the results and the continuation is scheduled: the tasks still
+        // running until the continuation destroys them must not touch either.
         try {
-            auto& results = std::get<ResultTypes>(result_);
             if constexpr (std::is_void_v<AwaitResult<Fut>>) { co_await std::forward<Fut>(fut); }
-            else { std::get<Idx>(results) = std::move(co_await std::forward<Fut>(fut)); }
+            else {
+                auto result = co_await std::forward<Fut>(fut);
+                if (! failed()) { std::get<Idx>(std::get<ResultTypes>(result_)) = std::move(result); }
+            }
             ++count_;
         } catch(...) {
-            result_ = std::current_exception();
+            if (! failed()) { result_ = std::current_exception(); }
         }
-        if (is_finished()) {
+        if (is_finished() && ! resumed_) {
+            resumed_ = true;
             get_event_loop().call_soon(*continuation_);
         }
     }
 private:
+    bool failed() const { return std::holds_alternative<std::exception_ptr>(result_); }
     bool is_finished() {
         return (count_ == sizeof...(Rs)
                 || std::get_if<std::exception_ptr>(&result_) != nullptr);
@@ -66,6 +72,7 @@ private:
     std::tuple<Task<std::void_t<Rs>>...> tasks_;
     CoroHandle* continuation_{};
     int count_{0};
+    bool resumed_{false};
 };
 
 template<concepts::Awaitable... Futs> // C++17 deduction guide
@@ -31,6 +31,8 @@ private:
     HandleId handle_id_;
     static std::atomic<HandleId> handle_id_generation_;
 protected:
+    // For handles that get rescheduled after being cancelled: the cancellation only applies to the old id.
+    void renew_handle_id() { handle_id_ = handle_id_generation_++; }
     State state_ {Handle::UNSCHEDULED};
 };
 
@@ -0,0 +1,121 @@
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+#include <asyncio/asyncio_ns.h>
+#include <asyncio/concept/bytebuf.h>
+#include <asyncio/expected.h>
+#include <asyncio/noncopyable.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+#include <asyncio/util.h>
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include <sys/socket.h>
+
+ASYNCIO_NS_BEGIN
+
+// One end of a byte stream within the process, see memory_stream_pair(). Reads, writes and shutdown() behave like
+// Stream's on a connected socket, with a buffer of a fixed capacity each way instead of the kernel's socket buffers:
+// no system calls, and no other traffic to interfere, so protocol handlers written against either can be benchmarked
+// and tested deterministically. A waiting reader or writer is resumed with `call_soon()` by the end that made progress
+// possible. Both ends must be used on the same thread.
+class MemoryStream : NonCopyable {
+public:
+    using Buffer = Stream::Buffer;
+
+    MemoryStream(MemoryStream&& other) = default;
+    ~MemoryStream();
+
+    // Shuts down both directions; further use fails with std::errc::bad_file_descriptor.
+    void close();
+    // Like Stream::shutdown(): with SHUT_WR the peer reads EOF once it read what we wrote, with SHUT_RD we read EOF
+    // and the peer's writes fail with std::errc::broken_pipe.
+    void shutdown(int how = SHUT_RDWR);
+
+    // Wait until there is something to read (or EOF), or room to write.
+    Task<> wait_readable();
+    Task<> wait_writable();
+
+    template <concepts::MutableByteBuf BUF = Buffer>
+    Task<BUF> read(ssize_t sz = -1, bool fill_buffer = false) {
+        BUF result;
+        if (sz >= 0) {
+            result.resize(size_t(sz), typename BUF::value_type{});
+            auto n = co_await read_bytes(std::as_writable_bytes(Spanify(result)), fill_buffer);
+            result.resize(n.value() / sizeof(typename BUF::value_type));
+            co_return result;
+        }
+        // until EOF
+        size_t size = 0;
+        while (true) {
+            result.resize(size + read_chunk, typename BUF::value_type{});
+            auto n = co_await read_bytes(std::as_writable_bytes(Spanify(result)).subspan(size), false);
+            if (n.value() == 0) { break; }
+            size += n.value();
+        }
+        result.resize(size);
+        co_return result;
+    }
+
+    // Like Stream::read_in_place(): a single read unless `fill_buffer`, an empty span at EOF.
+    template <typename T>
+    requires (std::has_unique_object_representations_v<T> && !std::is_const_v<T> && sizeof(T) == 1)
+    Task<std::span<T>> read_in_place(std::span<T> buffer, bool fill_buffer = false) {
+        auto n = co_await read_bytes(std::as_writable_bytes(buffer), fill_buffer);
+        co_return buffer.first(n.value());
+    }
+
+    // Like `read_in_place()`, but errors are returned rather than thrown.
+    template <typename T>
+    requires (std::has_unique_object_representations_v<T> && !std::is_const_v<T> && sizeof(T) == 1)
+    Task<Expected<std::span<T>>> try_read_in_place(std::span<T> buffer, bool fill_buffer = false) {
+        auto n = co_await read_bytes(std::as_writable_bytes(buffer), fill_buffer);
+        if (! n) [[unlikely]] { co_return n.error(); }
+        co_return buffer.first(n.value());
+    }
+
+    // Waits for room in the peer's buffer as needed. Fails with std::errc::broken_pipe once the peer stopped reading.
+    template<concepts::ByteBuf BUF>
+    Task<> write(const BUF& buf) {
+        auto result = co_await write_bytes(std::as_bytes(Spanify(buf)));
+        result.value();
+    }
+
+    // Like `write()`, but errors are returned rather than thrown.
+    template<concepts::ByteBuf BUF>
+    Task<Expected<void>> try_write(const BUF& buf) {
+        co_return co_await write_bytes(std::as_bytes(Spanify(buf)));
+    }
+
+    // Bytes written by the peer that weren't read yet.
+    size_t available() const;
+
+private:
+    friend std::pair<MemoryStream, MemoryStream> memory_stream_pair(size_t capacity);
+    static constexpr size_t read_chunk = 64 * 1024;
+    struct Pipe;
+    struct Shared;
+    struct WaitAwaiter;
+
+    MemoryStream(std::shared_ptr<Shared> shared, bool first): shared_(std::move(shared)), first_(first) { }
+
+    Pipe& rx() const;
+    Pipe& tx() const;
+    Task<Expected<size_t>> read_bytes(std::span<std::byte> buffer, bool fill_buffer);
+    Task<Expected<void>> write_bytes(std::span<const std::byte> bytes);
+
+    std::shared_ptr<Shared> shared_; // both directions, null once closed
+    bool first_;
+};
+
+// Two connected MemoryStreams, with a buffer of `capacity` bytes each way: a write waits while the buffer is full.
+std::pair<MemoryStream, MemoryStream> memory_stream_pair(size_t capacity = 64 * 1024);
+
+ASYNCIO_NS_END
@@ -4,14 +4,52 @@
 
 #pragma once
 #include <asyncio/asyncio_ns.h>
+#include <asyncio/expected.h>
+#include <asyncio/resolver.h>
 #include <asyncio/stream.h>
 #include <asyncio/task.h>
 
+#include <chrono>
 #include <cstdint>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 ASYNCIO_NS_BEGIN
 
-Task<Stream> open_connection(std::string_view ip, uint16_t port);
+struct ConnectOptions {
+    // Happy Eyeballs (RFC 8305) "Connection Attempt Delay": how long an attempt gets on its own before the next
+    // address is tried in parallel. The first attempt to connect wins, the others are cancelled.
+    std::chrono::milliseconds happy_eyeballs_delay{250};
+
+    // Numeric source addresses to bind outbound sockets to. Connections go round-robin over those matching the
+    // address family of the destination. Empty lets the kernel pick.
+    std::vector<std::string> local_addrs{};
+    // Bind source addresses with IP_BIND_ADDRESS_NO_PORT (Linux), so the source port is only picked by connect(),
+    // and only has to be unique per destination instead of per source address. Without it, every bound socket
+    // reserves a port exclusively, capping each source address at the size of the ephemeral port range.
+    bool bind_address_no_port{true};
+    // SO_REUSEADDR on outbound sockets, lets explicitly bound ports be reused while still in TIME_WAIT.
+    bool reuse_addr{false};
+    // Source ports to use, as an inclusive [first, last] range. {0, 0} means the system wide ephemeral range.
+    // Uses IP_LOCAL_PORT_RANGE (Linux >= 6.3), falls back to binding ports from the range one by one.
+    std::pair<uint16_t, uint16_t> local_port_range{0, 0};
+};
+
+Task<Stream> open_connection(std::string_view ip, uint16_t port, ConnectOptions options = {});
+
+// Connects to one of the already resolved `addrs`, in the order given, except that address families are interleaved.
+// If none of them can be connected to, throws std::system_error with the error of the last attempt that failed.
+Task<Stream> open_connection(std::vector<AddrInfo> addrs, ConnectOptions options = {});
+
+// Like `open_connection()`, but failures (unresolvable names, refused connections, ...) are returned rather than thrown.
+Task<Expected<Stream>> try_open_connection(std::string_view ip, uint16_t port, ConnectOptions options = {});
+Task<Expected<Stream>> try_open_connection(std::vector<AddrInfo> addrs, ConnectOptions options = {});
+
+// Connects to the AF_UNIX stream socket at `path` (see socket::unix_address()), for local IPC without the TCP/IP stack.
+Task<Stream> open_unix_connection(std::string_view path);
+// Like `open_unix_connection()`, but failures are returned rather than thrown.
+Task<Expected<Stream>> try_open_unix_connection(std::string_view path);
 
 ASYNCIO_NS_END
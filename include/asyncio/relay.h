@@ -0,0 +1,27 @@
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+#include <asyncio/asyncio_ns.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+
+#include <cstddef>
+
+ASYNCIO_NS_BEGIN
+
+struct RelayResult {
+    size_t a_to_b{}; // bytes
+    size_t b_to_a{};
+};
+
+// Pumps data both ways between two socket streams until both directions reached EOF, e.g. for a TCP proxy.
+//
+// On Linux the data is moved with splice(2) through a pipe per direction, so it never gets copied to user space.
+// Each direction only reads as much as it then manages to write, so a slow receiver slows down its sender instead of
+// data piling up. When one side sends EOF, the other side's sending direction is shut down (a half-close), and the
+// opposite direction keeps going. If a direction fails the error is rethrown, and the other one is stopped.
+Task<RelayResult> relay(Stream& a, Stream& b);
+
+ASYNCIO_NS_END
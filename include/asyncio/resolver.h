@@ -0,0 +1,150 @@
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+#include <asyncio/asyncio_ns.h>
+#include <asyncio/expected.h>
+#include <asyncio/handle.h>
+#include <asyncio/noncopyable.h>
+#include <asyncio/schedule_task.h>
+#include <asyncio/task.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <netdb.h>
+#include <sys/socket.h>
+
+ASYNCIO_NS_BEGIN
+
+// One resolved address, a self-contained (copyable) version of `struct addrinfo`.
+struct AddrInfo {
+    int family{};
+    int socktype{};
+    int protocol{};
+    sockaddr_storage addr{};
+    socklen_t addrlen{};
+
+    const sockaddr *sockaddr_ptr() const { return reinterpret_cast<const sockaddr *>(&addr); }
+};
+
+// Resolves host names without blocking the EventLoop. Numeric addresses are resolved inline, everything else is
+// handed to a small pool of worker threads which run the (blocking) lookup function. Completion is signalled back to
+// the loop through an eventfd (a pipe on non-Linux), which is only registered in the selector while lookups are in
+// flight, so an idle Resolver never keeps the EventLoop alive.
+//
+// Answers are kept in a per-Resolver cache: successful lookups for `cache_ttl`, names that don't exist (EAI_NONAME)
+// for `negative_ttl`. getaddrinfo(3) doesn't report record TTLs, hence these are fixed, configurable, lifetimes.
+// Answers are per name (and hints), not per port: looking a name up for another port is a cache hit. Concurrent lookups
+// of the same name are coalesced into a single query. A full cache makes room by dropping the answers that expire
+// first.
+//
+// A Resolver belongs to the EventLoop of the thread that created it, and must only be used from that thread.
+class Resolver : NonCopyable {
+    using MSDuration = std::chrono::milliseconds;
+public:
+    // Runs on a worker thread. Returns 0 on success, or one of the EAI_* error codes on failure, like getaddrinfo(3).
+    using Lookup = std::function<int(const std::string &host, const std::string &service, const addrinfo &hints,
+                                     std::vector<AddrInfo> &result)>;
+
+    static constexpr size_t default_num_threads = 4;
+    static constexpr MSDuration default_cache_ttl = std::chrono::seconds(30);
+    static constexpr MSDuration default_negative_ttl = std::chrono::seconds(5);
+    static constexpr size_t default_cache_size = 1024;
+
+    struct CacheStats {
+        size_t hits{};          // answered from the cache, including negative_hits
+        size_t negative_hits{}; // answered from the cache with "no such name"
+        size_t misses{};        // lookups actually handed to a worker
+        size_t coalesced{};     // joined a lookup for the same name that was already in flight
+    };
+
+    explicit Resolver(size_t num_threads = default_num_threads, Lookup lookup = system_lookup);
+    ~Resolver();
+
+    // Throws std::system_error(address_not_available) if the name could not be resolved.
+    Task<std::vector<AddrInfo>> resolve(std::string_view host, uint16_t port,
+                                        addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM});
+    // Like `resolve()`, but returns the address_not_available error rather than throwing it.
+    Task<Expected<std::vector<AddrInfo>>> try_resolve(std::string_view host, uint16_t port,
+                                                      addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM});
+
+    // The default Lookup: a plain getaddrinfo(3) call.
+    static int system_lookup(const std::string &host, const std::string &service, const addrinfo &hints,
+                             std::vector<AddrInfo> &result);
+
+    size_t num_threads() const { return num_threads_; }
+    size_t pending() const { return pending_; }
+
+    // A zero ttl disables caching of that kind of answer. Already cached answers keep their original expiry.
+    void set_cache_ttl(MSDuration ttl, MSDuration negative_ttl) { cache_ttl_ = ttl; negative_ttl_ = negative_ttl; }
+    void set_cache_size(size_t max_entries) { cache_size_ = max_entries; }
+    // Drops every cached answer, or only those for `host`. Lookups already in flight are unaffected.
+    void flush_cache();
+    void flush_cache(std::string_view host);
+    const CacheStats& cache_stats() const { return stats_; }
+    size_t cache_size() const { return cache_.size(); }
+
+private:
+    struct Job {
+        std::string key;
+        std::string host, service;
+        addrinfo hints{};
+        int rc{};
+        std::vector<AddrInfo> result;
+        std::vector<CoroHandle *> waiters; // coroutines leave this if they go away before the lookup completes
+    };
+    struct JobAwaiter;
+    struct CacheEntry {
+        std::string host;
+        MSDuration expires;
+        int rc{};
+        std::vector<AddrInfo> result;
+    };
+
+    // Fills in `result` and returns 0, or returns the EAI_* error code.
+    Task<int> lookup(std::string_view host, uint16_t port, addrinfo hints, std::vector<AddrInfo> &result);
+    void submit(std::shared_ptr<Job> job);
+    void cache_answer(const Job &job);
+    void worker();
+    Task<> dispatch_completions();
+    void notify_loop();
+    void drain_notifications();
+
+    const size_t num_threads_;
+    const Lookup lookup_;
+    int notify_fds_[2]{-1, -1}; // [0] is watched by the loop, [1] is written by workers (same fd for eventfd)
+    size_t pending_{0};
+    std::optional<ScheduledTask<Task<>>> dispatcher_;
+
+    MSDuration cache_ttl_{default_cache_ttl};
+    MSDuration negative_ttl_{default_negative_ttl};
+    size_t cache_size_{default_cache_size};
+    std::unordered_map<std::string, CacheEntry> cache_;
+    std::unordered_map<std::string, std::shared_ptr<Job>> in_flight_;
+    CacheStats stats_;
+
+    std::vector<std::thread> threads_; // started lazily, on first lookup that can't be resolved inline
+    std::mutex mut_;
+    std::condition_variable cond_;
+    std::deque<std::shared_ptr<Job>> queue_;  // guarded by mut_
+    std::vector<std::shared_ptr<Job>> done_;  // guarded by mut_
+    bool stopping_{false};                    // guarded by mut_
+};
+
+// Returns the Resolver for this thread's EventLoop. These live in thread_local storage, like the EventLoop itself.
+Resolver &get_resolver();
+
+ASYNCIO_NS_END
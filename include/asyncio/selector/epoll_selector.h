@@ -8,6 +8,9 @@
 
 #include <fmt/core.h>
 
+#include <cerrno>
+#include <system_error>
+#include <unordered_map>
 #include <vector>
 
 #include <unistd.h>
@@ -15,7 +18,7 @@
 
 ASYNCIO_NS_BEGIN
 struct EpollSelector {
-    EpollSelector(): epfd_(epoll_create1(0)) {
+    EpollSelector(): epfd_(epoll_create1(EPOLL_CLOEXEC)) {
         if (epfd_ < 0) {
             perror("epoll_create1");
             throw;
@@ -27,15 +30,20 @@ struct EpollSelector {
         events.resize(register_event_count_);
         int ndfs = epoll_wait(epfd_, events.data(), register_event_count_, timeout);
         std::vector<Event> result;
-        for (size_t i = 0; i < ndfs; ++i) {
-            auto handle_info = reinterpret_cast<HandleInfo*>(events[i].data.ptr);
-            if (handle_info->handle != nullptr && handle_info->handle != (Handle*)&handle_info->handle) {
-                result.emplace_back(Event {
-                    .handle_info = *handle_info
-                });
-            } else {
-                // mark event ready, but has no response callback
-                handle_info->handle = (Handle*)&handle_info->handle;
+        for (int i = 0; i < ndfs; ++i) {
+            auto interest = reinterpret_cast<Interest*>(events[i].data.ptr);
+            const uint32_t revents = events[i].events;
+            // errors and hang-ups are reported to whoever is waiting on the fd, so that they get to observe them,
+            // unless someone watches the error queue: then EPOLLERR is theirs
+            const uint32_t err = interest->errored ? 0u : uint32_t(EPOLLERR);
+            if (interest->reader && (revents & (EPOLLIN | EPOLLHUP | err))) {
+                dispatch(*interest->reader, result);
+            }
+            if (interest->writer && (revents & (EPOLLOUT | EPOLLHUP | err))) {
+                dispatch(*interest->writer, result);
+            }
+            if (interest->errored && (revents & (EPOLLERR | EPOLLHUP))) {
+                dispatch(*interest->errored, result);
             }
         }
         return result;
@@ -44,21 +52,88 @@ struct EpollSelector {
         if (epfd_ > 0) { close(epfd_); }
     }
     bool is_stop() { return register_event_count_ == 1; }
-    void register_event(const Event& event) {
-        epoll_event ev{ .events = event.flags, .data {.ptr = const_cast<HandleInfo*>(&event.handle_info) } };
-        if (epoll_ctl(epfd_, EPOLL_CTL_ADD, event.fd, &ev) == 0) {
-            ++register_event_count_;
+    int get_fd() const { return epfd_; }
+    // Whether anything (a Stream, a wait, a watcher) is registered for `fd` in that direction.
+    bool is_registered(int fd, Event::Flags flags) const {
+        auto iter = interests_.find(fd);
+        return iter != interests_.end() && iter->second.slot(flags) != nullptr;
+    }
+    // Returns the error of epoll_ctl(), if it failed: the event isn't registered then.
+    std::error_code register_event(const Event& event) {
+        // epoll allows only one registration per fd, so read & write interest on the same fd share one entry
+        auto [iter, inserted] = interests_.try_emplace(event.fd);
+        Interest& interest = iter->second;
+        auto& slot = interest.slot(event.flags);
+        const bool had_slot = slot != nullptr;
+        slot = const_cast<HandleInfo*>(&event.handle_info);
+        epoll_event ev{ .events = interest.flags(), .data {.ptr = &interest } };
+        int rc = epoll_ctl(epfd_, inserted ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, event.fd, &ev);
+        if (rc != 0 && ! inserted && errno == ENOENT) {
+            // fd was closed & reused without being removed first; the kernel already dropped the stale entry
+            rc = epoll_ctl(epfd_, EPOLL_CTL_ADD, event.fd, &ev);
         }
+        if (rc != 0) {
+            const int error = errno;
+            slot = nullptr;
+            if (interest.empty()) { interests_.erase(iter); }
+            return {error, std::generic_category()};
+        }
+        if (! had_slot) { ++register_event_count_; }
+        return {};
     }
 
     void remove_event(const Event& event) {
-        epoll_event ev{ .events = event.flags };
-        if (epoll_ctl(epfd_, EPOLL_CTL_DEL, event.fd, &ev) == 0) {
-            --register_event_count_;
+        auto iter = interests_.find(event.fd);
+        if (iter == interests_.end()) { return; }
+        Interest& interest = iter->second;
+        auto& slot = interest.slot(event.flags);
+        if (slot != &event.handle_info) { return; }
+        slot = nullptr;
+        --register_event_count_;
+        if (interest.empty()) {
+            epoll_event ev{ .events = event.flags };
+            epoll_ctl(epfd_, EPOLL_CTL_DEL, event.fd, &ev);
+            interests_.erase(iter);
+        } else {
+            epoll_event ev{ .events = interest.flags(), .data {.ptr = &interest } };
+            epoll_ctl(epfd_, EPOLL_CTL_MOD, event.fd, &ev);
         }
     }
 private:
+    // per fd registration, shared by the read and the write Event of that fd
+    struct Interest {
+        HandleInfo* reader {};
+        HandleInfo* writer {};
+        HandleInfo* errored {};
+        bool empty() const { return reader == nullptr && writer == nullptr && errored == nullptr; }
+        HandleInfo*& slot(Event::Flags flags) {
+            switch (flags) {
+                case Event::Flags::EVENT_READ: return reader;
+                case Event::Flags::EVENT_WRITE: return writer;
+                default: return errored;
+            }
+        }
+        HandleInfo* slot(Event::Flags flags) const { return const_cast<Interest*>(this)->slot(flags); }
+        uint32_t flags() const {
+            // EPOLLERR is always reported, there is no need to ask for it
+            return (reader ? uint32_t(Event::Flags::EVENT_READ) : 0u)
+                 | (writer ? uint32_t(Event::Flags::EVENT_WRITE) : 0u);
+        }
+    };
+
+    static void dispatch(HandleInfo& handle_info, std::vector<Event>& result) {
+        if (handle_info.handle != nullptr && handle_info.handle != (Handle*)&handle_info.handle) {
+            result.emplace_back(Event {
+                .handle_info = handle_info
+            });
+        } else {
+            // mark event ready, but has no response callback
+            handle_info.handle = (Handle*)&handle_info.handle;
+        }
+    }
+
     int epfd_;
     int register_event_count_ {1};
+    std::unordered_map<int, Interest> interests_; // node based: Interest addresses are stable for epoll_event.data
 };
 ASYNCIO_NS_END
@@ -26,7 +26,8 @@ struct Event {
         EVENT_WRITE = EVFILT_WRITE
     #elif defined(__linux__)
         EVENT_READ = EPOLLIN,
-        EVENT_WRITE = EPOLLOUT
+        EVENT_WRITE = EPOLLOUT,
+        EVENT_ERROR = EPOLLERR // the socket error queue, e.g. MSG_ZEROCOPY completions
     #else
         #error "Support only Linux & MacOS!"
     #endif
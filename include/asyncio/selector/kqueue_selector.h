@@ -10,6 +10,9 @@
 #include <chrono>
 #include <cstdio>
 #include <ranges>
+#include <set>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 #include <sys/event.h>
@@ -71,16 +74,29 @@ struct KQueueSelector {
         return register_event_count_ == 1;
     }
 
-    void register_event(const Event& event) {
+    int get_fd() const {
+        return kq_;
+    }
+
+    // Whether anything (a Stream, a wait, a watcher) is registered for `fd` in that direction.
+    bool is_registered(int fd, Event::Flags flags) const {
+        return registered_.contains({fd, static_cast<int16_t>(flags)});
+    }
+
+    // Returns the error of kevent(), if it failed: the event isn't registered then.
+    std::error_code register_event(const Event& event) {
         struct kevent ev {
             .ident = static_cast<uintptr_t>(event.fd),
             .filter = static_cast<int16_t>(event.flags),
             .flags = EV_ADD | EV_ENABLE,
             .udata = const_cast<HandleInfo*>(&event.handle_info)
         };
-        if (!kevent(kq_, &ev, 1, nullptr, 0, nullptr)) {
-            ++register_event_count_;
+        if (kevent(kq_, &ev, 1, nullptr, 0, nullptr) != 0) {
+            return {errno, std::generic_category()};
         }
+        ++register_event_count_;
+        registered_.insert({event.fd, static_cast<int16_t>(event.flags)});
+        return {};
     }
 
     void remove_event(const Event& event) {
@@ -93,11 +109,13 @@ struct KQueueSelector {
         if (!kevent(kq_, &ev, 1, nullptr, 0, nullptr)) {
             --register_event_count_;
         }
+        registered_.erase({event.fd, static_cast<int16_t>(event.flags)});
     }
 
 private:
     int kq_;
     int register_event_count_ { 1 };
+    std::set<std::pair<int, int16_t>> registered_; // (fd, filter)
     /* FIXME: Is there a needed? With zero (0) faster than one (1).
     "When Fa nevents is zero, kevent ();
 will return immediately even if there is a Fa timeout specified unlike select(2)."
@@ -0,0 +1,139 @@
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+#include <asyncio/asyncio_ns.h>
+#include <asyncio/concept/bytebuf.h>
+#include <asyncio/noncopyable.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+#include <asyncio/util.h>
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+ASYNCIO_NS_BEGIN
+
+namespace detail {
+struct ShmRing;
+}
+
+// A byte stream between two processes on the same host (or two threads, or one), through a pair of single producer,
+// single consumer rings in shared memory (a memfd) instead of a socket: writing and reading are a memcpy each, and
+// take no system call while the other side keeps up.
+//
+// Each side only rings the other's doorbell, an eventfd registered in its EventLoop, when the other side went to
+// sleep: a reader that is busy draining the ring, or a writer that isn't blocked on a full ring, gets no
+// notifications at all.
+//
+// One end create()s the channel, the other attach()es to the fds from the creator's `peer_fds()`, which can be sent to
+// another process with Stream::send_fds(). Reads and writes look like Stream's, so handlers can be written for either.
+// Linux only (memfd_create, eventfd); elsewhere create() throws std::errc::function_not_supported.
+//
+// Neither side trusts the other with more than the data: positions in the ring that don't add up fail reads and writes
+// with std::errc::protocol_error, the memfd is sealed against resizing, and a peer that exits (or crashes) without
+// closing its end is noticed through a socket pair between the two sides. Reads return EOF then, once the ring is
+// drained, and writes fail with std::errc::connection_reset.
+class ShmChannel : NonCopyable {
+public:
+    using Buffer = Stream::Buffer;
+    static constexpr size_t default_capacity = 1024 * 1024;
+
+    struct Stats {
+        size_t doorbells{}; // notifications sent to the other side
+        size_t waits{};     // times we had to go to sleep, for data or for room in the ring
+    };
+
+    // A new channel with rings of (at least) `capacity` bytes each way, rounded up to whole pages.
+    static ShmChannel create(size_t capacity = default_capacity);
+    // The other end of a channel, from the fds of its creator's `peer_fds()`. Takes ownership of the fds. Throws
+    // std::errc::invalid_argument if they aren't the fds of a channel.
+    static ShmChannel attach(std::span<const int> fds);
+
+    ShmChannel(ShmChannel&& other);
+    ~ShmChannel();
+
+    // The fds for attach()ing the other end: the memfd, the four eventfds, and the other end's half of the socket pair.
+    // The caller owns them, and should close them once sent: the other side is only seen going away once no copy of
+    // its socket is left. A channel has only two ends, so this hands them out once, and throws
+    // std::errc::bad_file_descriptor afterwards.
+    std::vector<int> peer_fds();
+
+    // Ends our direction, the peer reads EOF once it read everything before it, and unmaps the rings. Writes of the
+    // peer fail with std::errc::broken_pipe from then on.
+    void close();
+
+    template <concepts::MutableByteBuf BUF = Buffer>
+    Task<BUF> read(ssize_t sz = -1, bool fill_buffer = false) {
+        BUF result;
+        if (sz >= 0) {
+            result.resize(size_t(sz), typename BUF::value_type{});
+            size_t const n = co_await read_bytes(std::as_writable_bytes(Spanify(result)), fill_buffer);
+            result.resize(n / sizeof(typename BUF::value_type));
+            co_return result;
+        }
+        // until EOF
+        size_t size = 0;
+        while (true) {
+            result.resize(size + read_chunk, typename BUF::value_type{});
+            size_t const n = co_await read_bytes(std::as_writable_bytes(Spanify(result)).subspan(size), false);
+            if (n == 0) { break; }
+            size += n;
+        }
+        result.resize(size);
+        co_return result;
+    }
+
+    // Like Stream::read_in_place(): a single read unless `fill_buffer`, an empty span at EOF.
+    template <typename T>
+    requires (std::has_unique_object_representations_v<T> && !std::is_const_v<T> && sizeof(T) == 1)
+    Task<std::span<T>> read_in_place(std::span<T> buffer, bool fill_buffer = false) {
+        size_t const n = co_await read_bytes(std::as_writable_bytes(buffer), fill_buffer);
+        co_return buffer.first(n);
+    }
+
+    // Waits for room in the ring as needed. Throws std::system_error(broken_pipe) if the peer closed its end.
+    template<concepts::ByteBuf BUF>
+    Task<> write(const BUF& buf) {
+        co_await write_bytes(std::as_bytes(Spanify(buf)));
+    }
+
+    size_t capacity() const;
+    const Stats& stats() const { return stats_; }
+
+private:
+    static constexpr size_t read_chunk = 64 * 1024;
+    enum Fd { data_doorbell_0, space_doorbell_0, data_doorbell_1, space_doorbell_1, fd_count };
+
+    ShmChannel(int memfd, const int (&doorbells)[fd_count], int peer, bool creator);
+
+    Task<size_t> read_bytes(std::span<std::byte> buffer, bool fill_buffer);
+    Task<> write_bytes(std::span<const std::byte> bytes);
+    void ring_doorbell(int doorbell);
+    // Watches `peer_` for the other side going away, from the first time we wait on it.
+    void watch_peer();
+    void on_peer_gone();
+
+    int memfd_{-1};
+    std::byte* mapping_{};
+    size_t mapping_size_{};
+    detail::ShmRing* tx_{};
+    detail::ShmRing* rx_{};
+    // Waited on: the peer rings these when there is data to read, or room to write. Streams, for their registration.
+    Stream data_in_{-1};
+    Stream space_out_{-1};
+    // Rung by us
+    int data_out_{-1};
+    int space_in_{-1};
+    int peer_{-1};         // our end of the socket pair: EOF once the other side is gone
+    int peer_handoff_{-1}; // the creator's copy of the other end, until peer_fds() hands it out
+    bool creator_{};
+    bool watching_peer_{};
+    bool peer_gone_{};
+    Stats stats_;
+};
+
+ASYNCIO_NS_END
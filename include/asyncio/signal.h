@@ -0,0 +1,34 @@
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+#include <asyncio/asyncio_ns.h>
+#include <asyncio/task.h>
+
+#include <functional>
+
+ASYNCIO_NS_BEGIN
+
+// Signals as ordinary events of this thread's EventLoop, read from a signalfd (Linux; elsewhere these throw
+// std::errc::function_not_supported) rather than handled in signal context.
+//
+// A signal used with these is blocked, so that it stays pending until the loop reads it: a signal that comes in while
+// no one waits for it is delivered to the next wait_signal(). Blocking only applies to the calling thread, and to
+// threads it starts afterwards; other threads should block the signal themselves (pthread_sigmask()), or the kernel may
+// deliver it to one of them with its default action instead, typically terminating the process. Best use these, or
+// block the signals, in main() before any thread is started.
+//
+// With several loops (threads), each signal belongs to the first loop using it, and only that loop reads it, until its
+// thread exits. Using it from another thread fails with std::errc::device_or_resource_busy.
+
+// Waits until `signo` is delivered. All coroutines waiting for it at the time are resumed.
+Task<> wait_signal(int signo);
+
+// Like python's `loop.add_signal_handler()`: `callback` is called from the loop every time `signo` is delivered, until
+// it is removed. It replaces an earlier callback for `signo`. While any is added, the loop keeps running.
+void add_signal_handler(int signo, std::function<void()> callback);
+// Returns whether there was a callback for `signo` to remove. The signal stays blocked.
+bool remove_signal_handler(int signo);
+
+ASYNCIO_NS_END
@@ -5,6 +5,7 @@
 #pragma once
 #include <asyncio/asyncio_ns.h>
 #include <asyncio/finally.h>
+#include <asyncio/resolver.h>
 #include <asyncio/schedule_task.h>
 #include <asyncio/stream.h>
 
@@ -12,7 +13,9 @@
 
 #include <list>
 
+#include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/un.h>
 
 ASYNCIO_NS_BEGIN
 namespace concepts {
@@ -40,7 +43,7 @@ struct Server : NonCopyable {
             sockaddr_storage remoteaddr{};
             socklen_t addrlen = sizeof(remoteaddr);
             co_await ev_awaiter;
-            int clientfd = ::accept(fd_, reinterpret_cast<sockaddr*>(&remoteaddr), &addrlen);
+            int clientfd = socket::accept(fd_, reinterpret_cast<sockaddr*>(&remoteaddr), &addrlen);
             if (clientfd == -1) {
                 if (errno == EINTR) continue;
                 throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
@@ -77,26 +80,19 @@ private:
 
 template<concepts::ConnectCb CONNECT_CB>
 Task<Server<CONNECT_CB>> start_server(CONNECT_CB cb, std::string_view ip, uint16_t port) {
-    addrinfo hints { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM };
-    addrinfo *server_info {nullptr};
-    auto service = std::to_string(port);
-    // TODO: getaddrinfo is a blocking api
-    if (int rv = getaddrinfo(ip.data(), service.c_str(), &hints, &server_info);
-            rv != 0) {
-        throw std::system_error(std::make_error_code(std::errc::address_not_available));
-    }
-    finally{ freeaddrinfo(server_info); };
+    auto server_info = co_await get_resolver().resolve(ip, port);
 
     int serverfd = -1;
-    for (auto p = server_info; p != nullptr; p = p->ai_next) {
-        if ((serverfd = ::socket(p->ai_family, p->ai_socktype | socket::NonBlockFlag, p->ai_protocol)) == -1) {
+    for (const auto& p : server_info) {
+        if ((serverfd = ::socket(p.family, p.socktype | socket::NonBlockFlag | socket::CloExecFlag, p.protocol)) == -1) {
             continue;
         }
         socket::set_blocking(serverfd, false);
+        socket::set_cloexec(serverfd);
         int yes = 1;
         // lose the pesky "address already in use" error message
         setsockopt(serverfd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
-        if ( bind(serverfd, p->ai_addr, p->ai_addrlen) == 0) {
+        if ( bind(serverfd, p.sockaddr_ptr(), p.addrlen) == 0) {
             break;
         }
         close(serverfd);
@@ -113,4 +109,34 @@ Task<Server<CONNECT_CB>> start_server(CONNECT_CB cb, std::string_view ip, uint16
     co_return Server{cb, serverfd};
 }
 
+// Like `start_server()`, on the AF_UNIX stream socket at `path` (see socket::unix_address()). A socket file left at
+// `path` by an earlier server is replaced; the file is not removed when the server closes.
+template<concepts::ConnectCb CONNECT_CB>
+Task<Server<CONNECT_CB>> start_unix_server(CONNECT_CB cb, std::string_view path) {
+    sockaddr_un addr;
+    socklen_t const addrlen = socket::unix_address(path, addr);
+    if (addrlen == 0) {
+        throw std::system_error(std::make_error_code(std::errc::filename_too_long));
+    }
+    if (path.front() != '\0') {
+        struct stat st{};
+        if (::stat(addr.sun_path, &st) == 0 && S_ISSOCK(st.st_mode)) { ::unlink(addr.sun_path); }
+    }
+
+    int serverfd = ::socket(AF_UNIX, SOCK_STREAM | socket::NonBlockFlag | socket::CloExecFlag, 0);
+    if (serverfd == -1) {
+        throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+    }
+    socket::set_blocking(serverfd, false);
+    socket::set_cloexec(serverfd);
+    if (::bind(serverfd, reinterpret_cast<const sockaddr*>(&addr), addrlen) == -1
+        || ::listen(serverfd, max_connect_count) == -1) {
+        auto error = std::make_error_code(static_cast<std::errc>(errno));
+        ::close(serverfd);
+        throw std::system_error(error);
+    }
+
+    co_return Server{cb, serverfd};
+}
+
 ASYNCIO_NS_END
@@ -5,8 +5,11 @@
 
 #pragma once
 #include <asyncio/asyncio_ns.h>
+#include <asyncio/buffer_pool.h>
+#include <asyncio/chunked_buffer.h>
 #include <asyncio/concept/bytebuf.h>
 #include <asyncio/event_loop.h>
+#include <asyncio/expected.h>
 #include <asyncio/noncopyable.h>
 #include <asyncio/selector/event.h>
 #include <asyncio/task.h>
@@ -14,14 +17,25 @@
 
 #include <fmt/format.h>
 
+#include <cerrno>
+#include <chrono>
+#include <coroutine>
 #include <cstddef> // std::byte
+#include <memory>
+#include <ranges>
 #include <stdexcept>
+#include <system_error>
 #include <span>
+#include <string_view>
 #include <variant>
 #include <vector>
 
 #include <netdb.h>
+#include <pthread.h>
+#include <signal.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
 #include <unistd.h>
 
 ASYNCIO_NS_BEGIN
@@ -33,6 +47,43 @@ namespace socket {
     bool set_blocking(int fd, bool blocking);
 
     extern const int NonBlockFlag; // aka SOCK_NONBLOCK
+    // Sockets are close-on-exec, so that child processes don't keep our connections (and listening ports) open.
+    // Where SOCK_CLOEXEC doesn't exist, set_cloexec() sets it afterwards, and does nothing otherwise.
+    extern const int CloExecFlag; // aka SOCK_CLOEXEC
+    bool set_cloexec(int fd);
+    // accept() with a close-on-exec result: accept4() where there is one.
+    int accept(int fd, sockaddr* addr, socklen_t* addrlen);
+
+    // Fills in `addr` for the AF_UNIX socket at `path`, and returns its length, or 0 if `path` is too long. A path
+    // starting with '\0' names a socket in the abstract namespace (Linux), which has no file.
+    socklen_t unix_address(std::string_view path, sockaddr_un& addr);
+
+    // Runs `write`, a write(2)-like call without a MSG_NOSIGNAL (to a pipe, or splice() into a socket), so that a
+    // reader that went away makes it fail with EPIPE rather than raise SIGPIPE: SIGPIPE is blocked for the call, and
+    // the one it raised, if it did, is taken back before unblocking. Unless it is blocked already, SIGPIPE can't be
+    // pending before the call, so what is pending afterwards is ours. Elsewhere than Linux it just runs `write`.
+    template<typename Write>
+    ssize_t without_sigpipe(Write&& write) {
+#if defined(__linux__)
+        sigset_t sigpipe, old_mask;
+        sigemptyset(&sigpipe);
+        sigaddset(&sigpipe, SIGPIPE);
+        ::pthread_sigmask(SIG_BLOCK, &sigpipe, &old_mask);
+        ssize_t const sz = write();
+        if (! sigismember(&old_mask, SIGPIPE)) {
+            int const error = errno;
+            if (sz < 0 && error == EPIPE) {
+                timespec const no_wait{};
+                while (::sigtimedwait(&sigpipe, nullptr, &no_wait) == -1 && errno == EINTR) { }
+            }
+            ::pthread_sigmask(SIG_SETMASK, &old_mask, nullptr);
+            errno = error;
+        }
+        return sz;
+#else
+        return write();
+#endif
+    }
 } // namespace socket
 
 
@@ -44,13 +95,36 @@ uint16_t get_in_port(const sockaddr *sa);
 struct Stream : NonCopyable {
     using Buffer = std::vector<char>; // Default buffer for read() if nothing specified
     Stream(int fd);
+    // `sockinfo` (the peer address from accept()) isn't kept: get_sock_info() looks addresses up when asked for
     Stream(int fd, const sockaddr_storage& sockinfo);
     Stream(Stream&& other);
     ~Stream();
 
     void close();
 
-    void shutdown();
+    // Shuts down both directions by default. With `how = SHUT_WR` only our sending side is closed (the peer reads EOF)
+    // and the stream can still be read from; likewise SHUT_RD.
+    void shutdown(int how = SHUT_RDWR);
+
+    // Wait until the stream can be read from / written to without blocking. Waiting allocates nothing and holds no
+    // buffer, so it is the cheap way to park the handler of a mostly idle connection; see also read_pooled().
+    struct ReadinessAwaiter;
+    ReadinessAwaiter wait_readable();
+    ReadinessAwaiter wait_writable();
+
+    // Timeouts enforced by the stream itself, so reads and writes needn't each be wrapped in `wait_for()`. An expired
+    // timeout fails the pending read or write with std::errc::timed_out (thrown as std::system_error, or returned by
+    // the try_* variants); the stream stays usable. Zero, the default, disables a timeout.
+    //
+    // All of them share one timer per stream. It is only re-armed when it fires before the deadline moved on, or
+    // when a deadline moves closer, so reads and writes on a busy stream don't touch the timer at all.
+    //
+    // Read/write timeout: how long a single read or write may wait for the socket to become ready.
+    void set_read_timeout(std::chrono::milliseconds timeout);
+    void set_write_timeout(std::chrono::milliseconds timeout);
+    // Idle timeout: how long a read or write may wait since the stream last got to read or write, e.g. to reap idle
+    // keep-alive connections while a handler waits for their next request.
+    void set_idle_timeout(std::chrono::milliseconds timeout);
 
     template <concepts::MutableByteBuf BUF = Buffer>
     Task<BUF> read(ssize_t sz = -1, bool fill_buffer = false) {
@@ -71,13 +145,22 @@ struct Stream : NonCopyable {
     template <typename T>
     requires (std::has_unique_object_representations_v<T> && !std::is_const_v<T> && sizeof(T) == 1)
     Task<std::span<T>> read_in_place(std::span<T> buffer, bool fill_buffer = false) {
+        auto result = co_await try_read_in_place(buffer, fill_buffer);
+        co_return std::move(result).value();
+    }
+
+    // Like `read_in_place()`, but errors such as ECONNRESET are returned rather than thrown.
+    template <typename T>
+    requires (std::has_unique_object_representations_v<T> && !std::is_const_v<T> && sizeof(T) == 1)
+    Task<Expected<std::span<T>>> try_read_in_place(std::span<T> buffer, bool fill_buffer = false) {
         std::span bytebuf = std::as_writable_bytes(buffer);
         size_t nread = 0;
         while ( ! bytebuf.empty()) {
-            co_await read_awaiter_;
-            ssize_t const sz = ::read(read_fd_, bytebuf.data(), bytebuf.size());
+            std::error_code const timeout = co_await readable();
+            if (timeout) [[unlikely]] { co_return timeout; }
+            ssize_t const sz = ::read(get_fd(), bytebuf.data(), bytebuf.size());
             if (sz < 0) [[unlikely]] {
-                throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+                co_return std::make_error_code(static_cast<std::errc>(errno));
             } else if (size_t(sz) > bytebuf.size()) [[unlikely]] {
                 throw std::runtime_error(fmt::format("Unexpected size returned from read(): {} > {}", sz, bytebuf.size()));
             }
@@ -88,28 +171,109 @@ struct Stream : NonCopyable {
         co_return buffer.first(nread / sizeof(T)); // return a view into the bytes we actually read
     }
 
+    // Waits for data, and only then borrows a buffer of (up to) `size` bytes from this thread's BufferPool, default its
+    // block size, for a single read(). Until the peer sends something, nothing but the Stream and the waiting
+    // coroutine is held per connection. Returns the data read, or an empty lease at EOF.
+    Task<BufferLease> read_pooled(size_t size = 0);
+    // Like `read_pooled()`, but errors such as ECONNRESET are returned rather than thrown.
+    Task<Expected<BufferLease>> try_read_pooled(size_t size = 0);
+
     template<concepts::ByteBuf BUF>
     Task<> write(const BUF& buf) {
+        auto result = co_await try_write(buf);
+        result.value();
+    }
+
+    // Like `write()`, but errors such as EPIPE are returned rather than thrown.
+    template<concepts::ByteBuf BUF>
+    Task<Expected<void>> try_write(const BUF& buf) {
         std::span bytes2write = std::as_bytes(Spanify(buf));
         while (! bytes2write.empty()) {
-            co_await write_awaiter_;
-            ssize_t sz = ::write(write_fd_, bytes2write.data(), bytes2write.size());
+            std::error_code const timeout = co_await writable();
+            if (timeout) [[unlikely]] { co_return timeout; }
+            ssize_t sz = write_some(bytes2write.data(), bytes2write.size());
             if (sz < 0) [[unlikely]] {
-                throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+                co_return std::make_error_code(static_cast<std::errc>(errno));
             } else if (sz == 0) [[unlikely]] {
-                throw std::system_error(std::error_code{}, "write() returned 0 bytes; EOF");
+                co_return std::make_error_code(std::errc::broken_pipe); // write() returned 0 bytes; EOF
             } else if (size_t(sz) > bytes2write.size()) [[unlikely]] {
                 throw std::runtime_error(fmt::format("Unexpected size returned from write(): {} > {}", sz, bytes2write.size()));
             }
             // advance read pos
             bytes2write = bytes2write.last(bytes2write.size() - size_t(sz));
         }
-        co_return;
+        co_return Expected<void>{};
+    }
+
+    // Scatter read into a range of byte buffers (e.g. a header and a body), filled in order. Returns the number of
+    // bytes read. Like `read_in_place()`, it does a single readv() unless `fill_buffers` is true, in which case it keeps
+    // reading until all buffers are full or EOF.
+    template<std::ranges::range R>
+    requires concepts::MutableByteBuf<std::ranges::range_value_t<R>>
+    Task<size_t> read_vectored(R&& bufs, bool fill_buffers = false) {
+        co_return co_await readv_all(to_iovecs(bufs), fill_buffers);
+    }
+
+    // Gather write of a range of byte buffers, in order, as if they were one: no copying into a contiguous buffer and
+    // as few writev() calls as the socket allows.
+    template<std::ranges::range R>
+    requires concepts::ByteBuf<std::ranges::range_value_t<R>>
+    Task<> write_vectored(const R& bufs) {
+        co_await writev_all(to_iovecs(bufs));
     }
 
-    // Local address if `peer==false`, remote address if `peer==true`
+    // Does one readv() into `buf`, sized by its AdaptiveReadSize. Returns the number of bytes read, 0 on EOF.
+    Task<size_t> read_some(ChunkedBuffer& buf);
+    // Reads until EOF into a ChunkedBuffer. Unlike `read()` this doesn't copy the data into one contiguous buffer.
+    Task<ChunkedBuffer> read_chunked();
+
+    // Sends `count` bytes of `file_fd` starting at `offset` (which doesn't change the file position), without copying
+    // them through user space where the OS supports it. Returns the number of bytes sent, which is less than `count`
+    // only if the file ended first.
+    Task<size_t> sendfile(int file_fd, off_t offset, size_t count);
+
+    // Does one writev() of `iov` (at most IOV_MAX buffers of it), waiting for the fd to become writable only if it
+    // would block. Returns the number of bytes written, which may be fewer than asked for.
+    Task<size_t> writev(std::span<const iovec> iov);
+
+    // Passes open file descriptors (e.g. accepted sockets) to the process at the other end of an AF_UNIX stream, with
+    // SCM_RIGHTS. They go along with a single marker byte, which `recv_fds()` on the other end consumes, so fds and
+    // ordinary data must only be interleaved where both sides agree on it. The fds stay open here too; at most 253
+    // (SCM_MAX_FD) go in one call.
+    Task<> send_fds(std::span<const int> fds);
+    // Receives the fds of one `send_fds()`, at most `max_fds` (at least 1) of them; they are close-on-exec where
+    // supported. Returns an empty vector at EOF. Fails with std::errc::message_size, and closes what did arrive, if more
+    // were sent.
+    Task<std::vector<int>> recv_fds(size_t max_fds = 16);
+    // Like `send_fds()` and `recv_fds()`, but errors are returned rather than thrown.
+    Task<Expected<void>> try_send_fds(std::span<const int> fds);
+    Task<Expected<std::vector<int>>> try_recv_fds(size_t max_fds = 16);
+
+    // Zero-copy sends with MSG_ZEROCOPY (Linux, TCP). Returns false if the socket doesn't support it, in which case
+    // `write_zerocopy()` just copies like `write()`.
+    bool set_zerocopy(bool enable);
+    bool get_zerocopy() const { return zerocopy_ != nullptr; }
+
+    // Writes smaller than this are copied even with zero-copy enabled: pinning the pages and reaping the completion
+    // costs more than the copy saves.
+    static constexpr size_t zerocopy_threshold = 10 * 1024;
+
+    // Like `write()`, but with zero-copy enabled the kernel sends straight from `buf`'s pages. Only returns once the
+    // kernel reported that it is done with them, so `buf` may be reused or freed right after.
+    template<concepts::ByteBuf BUF>
+    Task<> write_zerocopy(const BUF& buf) {
+        co_await send_zerocopy(std::as_bytes(Spanify(buf)));
+    }
+
+    struct ZeroCopyStats {
+        size_t sends{};  // send() calls that went out with MSG_ZEROCOPY
+        size_t copied{}; // completions for which the kernel fell back to copying anyway (e.g. over loopback)
+    };
+    ZeroCopyStats zerocopy_stats() const;
+
+    // Local address if `peer==false`, remote address if `peer==true`. Looked up on first use.
     const sockaddr_storage &
-    get_sock_info(bool peer = false) const { return peer ? peer_sock_info_ : sock_info_; }
+    get_sock_info(bool peer = false) const;
 
     // Returns the address of either the locally bound socket if `peer == false`, or the remote peer if `peer == true`.
     // Throws if `ss_family` is not `AF_INET` or `AF_INET6`, otherwise returns a valid variant.
@@ -118,36 +282,101 @@ struct Stream : NonCopyable {
 
     uint16_t get_port(bool peer = false) const;
 
+    // The underlying fd, or -1 if the stream was closed. The Stream keeps ownership of it.
+    int get_fd() const { return read_ev_.fd; }
+
 private:
     template <concepts::MutableByteBuf BUF = Buffer>
     Task<BUF> read_until_eof() {
-        BUF result;
-        ssize_t current_read = 0;
-        size_t total_read = 0;
-        do {
-            result.resize(total_read + chunk_size);
-            co_await read_awaiter_;
-            current_read = ::read(read_fd_, result.data() + total_read, chunk_size);
-            if (current_read < 0) {
-                throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
-            }
-            if (size_t(current_read) < chunk_size) { result.resize(total_read + current_read); }
-            total_read += current_read;
-        } while (current_read > 0);
-        co_return result;
+        auto chunks = co_await read_chunked();
+        co_return chunks.template flatten<BUF>();
+    }
+
+    // write(2), except that a peer that went away makes it fail with EPIPE rather than raise SIGPIPE
+    ssize_t write_some(const void* data, size_t size);
+    // writev(2), likewise: sendmsg() with MSG_NOSIGNAL on a socket
+    ssize_t writev_some(std::span<const iovec> iov);
+
+    template<std::ranges::range R>
+    static std::vector<iovec> to_iovecs(R&& bufs) {
+        std::vector<iovec> iov;
+        if constexpr (std::ranges::sized_range<R>) { iov.reserve(std::ranges::size(bufs)); }
+        for (auto&& buf : bufs) {
+            if (buf.size() == 0) { continue; }
+            // writev() takes a non-const iov_base, but doesn't write through it
+            iov.push_back({ .iov_base = const_cast<void*>(static_cast<const void*>(buf.data())), .iov_len = buf.size() });
+        }
+        return iov;
     }
+    Task<size_t> readv_all(std::vector<iovec> iov, bool fill_buffers);
+    Task<> writev_all(std::vector<iovec> iov);
 
-    int read_fd_{-1};
-    int write_fd_{-1};
-    bool is_shut_down = false;
-    Event read_ev_ { .fd = read_fd_, .flags = Event::Flags::EVENT_READ };
-    Event write_ev_ { .fd = write_fd_, .flags = Event::Flags::EVENT_WRITE };
-    EventLoop::WaitEventAwaiter read_awaiter_ { get_event_loop().wait_event(read_ev_) };
-    EventLoop::WaitEventAwaiter write_awaiter_ { get_event_loop().wait_event(write_ev_) };
-    sockaddr_storage sock_info_{}, peer_sock_info_{};
-    static constexpr size_t chunk_size = 4096;
+    // Waits until the fd is readable (or writable), then returns std::errc::timed_out if a timeout expired meanwhile,
+    // or an empty error_code. Works like EventLoop::WaitEventAwaiter, but on the Stream's own Events, which stay
+    // registered from the first wait until the stream is shut down or closed.
+    struct IoAwaiter {
+        bool await_ready() noexcept {
+            HandleInfo& info = event().handle_info;
+            bool ready = (info.handle == (const Handle*)&info.handle);
+            info.handle = nullptr;
+            return ready;
+        }
+        template<typename Promise>
+        void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            handle.promise().set_state(Handle::SUSPEND);
+            event().handle_info = {
+                .id = handle.promise().get_handle_id(),
+                .handle = &handle.promise()
+            };
+            stream_.register_event(reading_);
+            if (stream_.deadlines_) { stream_.begin_wait(reading_); }
+        }
+        [[nodiscard]] std::error_code await_resume() noexcept {
+            event().handle_info = { };
+            return stream_.deadlines_ ? stream_.end_wait(reading_) : std::error_code{};
+        }
+
+        Event& event() { return reading_ ? stream_.read_ev_ : stream_.write_ev_; }
+
+        Stream& stream_;
+        bool reading_;
+    };
+    IoAwaiter readable() { return {*this, true}; }
+    IoAwaiter writable() { return {*this, false}; }
+    void register_event(bool reading) noexcept;
+    void remove_event(bool reading) noexcept;
+    void begin_wait(bool reading) noexcept;
+    std::error_code end_wait(bool reading) noexcept;
+    void expire(bool reading);
+
+    struct Deadlines;
+    struct ZeroCopyState;
+    struct Addresses;
+    Task<> send_zerocopy(std::span<const std::byte> bytes);
+
+    // Kept small, for servers holding on to a lot of mostly idle connections: the fd lives in the Events the selector
+    // points to, and everything that not every connection needs is allocated on first use.
+    Event read_ev_ { .fd = -1, .flags = Event::Flags::EVENT_READ };
+    Event write_ev_ { .fd = -1, .flags = Event::Flags::EVENT_WRITE };
+    bool read_registered_ : 1 = false;
+    bool write_registered_ : 1 = false;
+    bool is_shut_down : 1 = false;
+    bool not_socket_ : 1 = false; // a pipe, tty, file...: write_some() and writev_some() skip send()/sendmsg()
+    std::unique_ptr<Deadlines> deadlines_; // only once a timeout was set
+    std::unique_ptr<ZeroCopyState> zerocopy_; // only while zero-copy is enabled
+    mutable std::unique_ptr<Addresses> addresses_; // only once asked for
 };
 
+struct Stream::ReadinessAwaiter : Stream::IoAwaiter {
+    void await_resume() {
+        std::error_code const timeout = IoAwaiter::await_resume();
+        if (timeout) [[unlikely]] { throw std::system_error(timeout); }
+    }
+};
+
+inline Stream::ReadinessAwaiter Stream::wait_readable() { return {readable()}; }
+inline Stream::ReadinessAwaiter Stream::wait_writable() { return {writable()}; }
+
 // Returns a type-erased pointer either of type `in_addr *` or `in6_addr *`. Throws if `sa->sa_family` is neither
 // `AF_INET` nor `AF_INET6`. Don't use this function, since it is not type safe. Use `Stream::get_sockaddr` above instead
 // which is more type-safe.
@@ -0,0 +1,71 @@
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+#include <asyncio/asyncio_ns.h>
+#include <asyncio/exception.h>
+#include <asyncio/noncopyable.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+ASYNCIO_NS_BEGIN
+
+// Buffered reading on top of a Stream, like python's `asyncio.StreamReader`.
+//
+// The reader fills an internal buffer with large reads, so many small frames get parsed out of a single read()
+// syscall, and the buffer is reused for the lifetime of the reader. The spans returned point into that buffer: they
+// stay valid until the next call on the reader that may read from the stream (anything returning a Task).
+//
+// The Stream must outlive the reader. Don't read from the Stream directly while a reader still has data buffered.
+class StreamReader : NonCopyable {
+public:
+    static constexpr size_t default_read_size = 64 * 1024; // bytes asked for per read() syscall
+    static constexpr size_t default_limit = 64 * 1024;     // max bytes readuntil() buffers looking for a delimiter
+
+    explicit StreamReader(Stream& stream, size_t read_size = default_read_size, size_t limit = default_limit)
+        : stream_(stream), read_size_(read_size ? read_size : default_read_size), limit_(limit) { }
+
+    // Whatever is currently buffered, without reading from the stream.
+    std::span<const char> buffered() const { return {buf_.data() + begin_, end_ - begin_}; }
+    // True once EOF has been seen and the buffer is drained.
+    bool at_eof() const { return eof_ && begin_ == end_; }
+
+    // Reads until at least `n` bytes are buffered, or EOF, and returns all buffered bytes without consuming them.
+    Task<std::span<const char>> peek(size_t n = 1);
+    // Drops the first `n` buffered bytes (at most everything that is buffered).
+    void consume(size_t n);
+
+    // Returns up to `n` bytes, reading from the stream only if nothing is buffered. Empty means EOF.
+    Task<std::span<const char>> read(size_t n);
+    // Returns exactly `n` bytes. Throws IncompleteReadError if EOF comes first, leaving the partial data buffered.
+    Task<std::span<const char>> readexactly(size_t n);
+    // Returns the bytes up to and including `delim`. Throws LimitOverrunError if it's not found within the limit,
+    // or IncompleteReadError on EOF; in both cases the data stays buffered.
+    Task<std::span<const char>> readuntil(std::string_view delim);
+    // Same as readuntil("\n").
+    Task<std::span<const char>> readline() { return readuntil("\n"); }
+
+    Stream& stream() { return stream_; }
+    size_t limit() const { return limit_; }
+
+private:
+    // Does a single read() from the stream into the buffer, making room for at least `want` buffered bytes first.
+    // Returns false on EOF.
+    Task<bool> fill(size_t want);
+    std::span<const char> take(size_t n);
+
+    Stream& stream_;
+    size_t read_size_;
+    size_t limit_;
+    std::vector<char> buf_;
+    size_t begin_{0}, end_{0}; // buffered data is [begin_, end_)
+    bool eof_{false};
+};
+
+ASYNCIO_NS_END
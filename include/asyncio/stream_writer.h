@@ -0,0 +1,111 @@
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+#include <asyncio/asyncio_ns.h>
+#include <asyncio/buffer_pool.h>
+#include <asyncio/concept/bytebuf.h>
+#include <asyncio/handle.h>
+#include <asyncio/noncopyable.h>
+#include <asyncio/schedule_task.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+#include <asyncio/util.h>
+
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <list>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <sys/uio.h>
+
+ASYNCIO_NS_BEGIN
+
+struct StreamWriterOptions {
+    size_t high_water{64 * 1024}; // drain() waits while more than this is buffered...
+    size_t low_water{16 * 1024};  // ...until it's down to this
+    bool auto_flush{true};        // flush what was written at the end of the current loop tick, else only on flush()
+};
+
+// Buffered writing on top of a Stream, like python's `asyncio.StreamWriter`.
+//
+// write() only queues the data; the queue is sent with writev(), so that e.g. a header and a body written by a
+// handler in the same loop tick go out with one syscall. Data is either copied (small writes are coalesced into one
+// buffer), moved in (a vector or a BufferLease), or borrowed, in which case the caller keeps it alive until flush() or
+// drain() says it's sent.
+// Use drain() after writing for backpressure, and flush() to wait until everything is sent.
+//
+// Errors while sending are reported by the next drain(), flush() or write(). Whatever is still queued when the writer
+// goes away is dropped. The Stream must outlive the writer.
+class StreamWriter : NonCopyable {
+public:
+    struct Stats {
+        size_t syscalls{}; // writev() calls that sent something
+        size_t bytes{};
+    };
+
+    explicit StreamWriter(Stream& stream, StreamWriterOptions options = {})
+        : stream_(stream), options_(options) { }
+
+    // Queues a copy of `buf`.
+    template<concepts::ByteBuf BUF>
+    void write(const BUF& buf) { write_copy(std::as_bytes(Spanify(buf))); }
+    // Queues `buf` without copying it.
+    void write(std::vector<char>&& buf);
+    void write(BufferLease&& buf);
+    // Queues `buf` without copying or owning it: it must stay alive until it was sent.
+    void write_borrowed(std::span<const char> buf);
+
+    // Waits until no more than `low_water` bytes are queued, if more than `high_water` are.
+    Task<> drain();
+    // Sends everything queued, and waits until it's sent.
+    Task<> flush();
+
+    size_t buffered() const { return buffered_; }
+    const Stats& stats() const { return stats_; }
+    Stream& stream() { return stream_; }
+
+private:
+    struct Chunk {
+        std::vector<char> owned;
+        BufferLease lease;
+        std::span<const char> borrowed;
+        bool coalesce{false}; // a buffer of copies, later copies may be appended to it
+        std::span<const char> data() const {
+            if (borrowed.data()) { return borrowed; }
+            if (lease.data()) { return {lease.data(), lease.size()}; }
+            return owned;
+        }
+    };
+    struct Waiter {
+        CoroHandle* handle;
+        size_t threshold; // resumed once no more than this is buffered
+    };
+    struct WaitAwaiter;
+
+    void write_copy(std::span<const std::byte> bytes);
+    void queued(size_t size);
+    void start_flush();
+    Task<> flush_queue();
+    void consume(size_t sent);
+    void wake_waiters();
+    void rethrow_error() const;
+
+    Stream& stream_;
+    StreamWriterOptions options_;
+    Stats stats_;
+    std::deque<Chunk> chunks_;
+    size_t sent_from_front_{0}; // bytes of chunks_.front() already sent
+    size_t buffered_{0};
+    std::vector<iovec> iov_; // reused for every writev()
+    std::list<Waiter> waiters_;
+    std::exception_ptr error_;
+    bool flushing_{false};
+    std::optional<ScheduledTask<Task<>>> flusher_; // declared last, so that it goes away first
+};
+
+ASYNCIO_NS_END
@@ -0,0 +1,96 @@
+//
+// Created on 2026/10/18.
+//
+
+#pragma once
+#include <asyncio/asyncio_ns.h>
+#include <asyncio/noncopyable.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+
+#include <csignal>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+
+ASYNCIO_NS_BEGIN
+
+struct SubprocessOptions {
+    // Where the child's stdin, stdout and stderr go: a pipe to us (a Stream of the Subprocess), the same place as ours,
+    // or /dev/null.
+    enum class Redirect { pipe, inherit, devnull };
+    Redirect stdin_to{Redirect::pipe};
+    Redirect stdout_to{Redirect::pipe};
+    Redirect stderr_to{Redirect::inherit};
+    // The child's environment, as "NAME=value" entries; ours if not given.
+    std::optional<std::vector<std::string>> env;
+};
+
+// A child process, like python's `asyncio.subprocess.Process`. Its pipes are ordinary Streams, and waiting for it to
+// exit is waiting for its pidfd (Linux 5.3+) to become readable, so neither blocks the loop.
+//
+// A Subprocess that goes away before its process was waited for leaves the process running, and then a zombie until
+// ours exits: wait() for it, after kill() if need be. Writing to the stdin of a child that exited fails with
+// std::errc::broken_pipe, without raising SIGPIPE.
+class Subprocess : NonCopyable {
+public:
+    Subprocess(Subprocess&& other);
+    ~Subprocess();
+
+    // The parent's ends of the pipes asked for in SubprocessOptions, empty otherwise. Closing `stdin_pipe` is how
+    // the child reads EOF.
+    std::optional<Stream> stdin_pipe;
+    std::optional<Stream> stdout_pipe;
+    std::optional<Stream> stderr_pipe;
+
+    pid_t pid() const { return pid_; }
+
+    // Waits for the process to exit, and returns its exit code, or -N if it was killed by signal N. Any number of
+    // coroutines may wait at the same time: the first one watches the process, and the others get its result.
+    Task<int> wait();
+    // The result of wait() once the process was waited for.
+    std::optional<int> returncode() const { return returncode_; }
+
+    // Sends `signo` to the process (through its pidfd, so never to another process that reused the pid). Does nothing
+    // once the process was waited for.
+    void send_signal(int signo);
+    void terminate() { send_signal(SIGTERM); }
+    void kill() { send_signal(SIGKILL); }
+
+    // Writes `input` to stdin and closes it, while reading stdout and stderr until EOF, then waits for the process to
+    // exit: the way to run a filter without deadlocking on full pipes. Returns what the child wrote to stdout and to
+    // stderr (empty for those that aren't pipes).
+    Task<std::pair<std::string, std::string>> communicate(std::string_view input = {});
+
+private:
+    friend Subprocess create_subprocess_exec(const std::string& program, const std::vector<std::string>& args,
+                                             const SubprocessOptions& options);
+    struct WatcherAwaiter;
+
+    Subprocess(pid_t pid, int pidfd) : pid_(pid), pidfd_(pidfd) { }
+    void reaped(int status);
+    // Waits until the process exited, and reaps it. The pidfd takes a single waiter, so only one wait() at a time
+    // watches, see `watching_`.
+    Task<> watch();
+
+    pid_t pid_{-1};
+    int pidfd_{-1}; // -1 where there are no pidfds: wait() polls then
+    std::optional<int> returncode_;
+    bool watching_{false};
+    std::vector<CoroHandle*> waiters_; // the other wait()s, until the one in watch() is done
+};
+
+// Starts `program` (looked up in PATH unless it contains a '/') with arguments `args`, and `program` as argv[0].
+// The child is started with posix_spawn(), which on Linux shares our memory until the exec instead of copying our page
+// tables as fork() would, so spawning doesn't get slower as our RSS grows. It starts with no signals blocked, and
+// SIGPIPE at its default action, whatever ours are. It inherits stdin, stdout and stderr only: with glibc 2.34+ all
+// other fds are closed in the child, elsewhere those that aren't close-on-exec stay open (the library's own are all
+// close-on-exec). Throws std::system_error if the program can't be started.
+Subprocess create_subprocess_exec(const std::string& program, const std::vector<std::string>& args = {},
+                                  const SubprocessOptions& options = {});
+
+ASYNCIO_NS_END
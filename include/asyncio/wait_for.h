@@ -8,6 +8,7 @@
 #include <asyncio/concept/future.h>
 #include <asyncio/event_loop.h>
 #include <asyncio/exception.h>
+#include <asyncio/expected.h>
 #include <asyncio/handle.h>
 #include <asyncio/noncopyable.h>
 #include <asyncio/result.h>
@@ -16,16 +17,28 @@
 
 #include <chrono>
 #include <coroutine>
+#include <system_error>
 #include <type_traits>
 #include <utility>
 
 ASYNCIO_NS_BEGIN
 namespace detail {
-template<typename R, typename Duration>
+// With `NoThrow`, a timeout is returned as `Expected<R>{std::errc::timed_out}` instead of thrown as a TimeoutError.
+template<typename R, typename Duration, bool NoThrow = false>
 struct WaitForAwaiter : NonCopyable {
     constexpr bool await_ready() noexcept { return result_.has_value(); }
     constexpr decltype(auto) await_resume() {
-        return std::move(result_).result();
+        if constexpr (NoThrow) {
+            if (timed_out_) { return Expected<R>{std::make_error_code(std::errc::timed_out)}; }
+            if constexpr (std::is_void_v<R>) {
+                std::move(result_).result();
+                return Expected<R>{};
+            } else {
+                return Expected<R>{std::move(result_).result()};
+            }
+        } else {
+            return std::move(result_).result();
+        }
     }
 
     template<typename Promise>
@@ -61,6 +74,7 @@ private:
 
 private:
     Result<R> result_;
+    bool timed_out_{false};
     CoroHandle* continuation_{};
 
 private:
@@ -71,7 +85,10 @@ private:
         }
         void run() override final { // timeout!
             awaiter_.wait_for_task_.cancel();
-            awaiter_.result_.set_exception(std::make_exception_ptr(TimeoutError{}));
+            awaiter_.timed_out_ = true;
+            if constexpr (! NoThrow) {
+                awaiter_.result_.set_exception(std::make_exception_ptr(TimeoutError{}));
+            }
 
             get_event_loop().call_soon(*awaiter_.continuation_);
         }
@@ -84,13 +101,13 @@ private:
 template<concepts::Awaitable Fut, typename Duration>
 WaitForAwaiter(Fut&&, Duration) -> WaitForAwaiter<AwaitResult<Fut>, Duration>;
 
-template<concepts::Awaitable Fut, typename Duration>
+template<concepts::Awaitable Fut, typename Duration, bool NoThrow = false>
 struct WaitForAwaiterRegistry {
     WaitForAwaiterRegistry(Fut&& fut, Duration duration)
     : fut_(std::forward<Fut>(fut)), duration_(duration) { }
 
     auto operator co_await () && {
-        return WaitForAwaiter{std::forward<Fut>(fut_), duration_};
+        return WaitForAwaiter<AwaitResult<Fut>, Duration, NoThrow>{std::forward<Fut>(fut_), duration_};
     }
 private:
     Fut fut_; // lift Awaitable's lifetime
@@ -105,6 +122,13 @@ auto wait_for(NoWaitAtInitialSuspend, Fut&& fut, std::chrono::duration<Rep, Peri
 -> Task<AwaitResult<Fut>> { // lift awaitable type(WaitForAwaiterRegistry) to coroutine
     co_return co_await WaitForAwaiterRegistry { std::forward<Fut>(fut), timeout };
 }
+
+template<concepts::Awaitable Fut, typename Rep, typename Period>
+auto try_wait_for(NoWaitAtInitialSuspend, Fut&& fut, std::chrono::duration<Rep, Period> timeout)
+-> Task<Expected<AwaitResult<Fut>>> {
+    using Duration = std::chrono::duration<Rep, Period>;
+    co_return co_await WaitForAwaiterRegistry<Fut, Duration, true> { std::forward<Fut>(fut), timeout };
+}
 }
 
 template<concepts::Awaitable Fut, typename Rep, typename Period>
@@ -112,4 +136,12 @@ template<concepts::Awaitable Fut, typename Rep, typename Period>
 Task<AwaitResult<Fut>> wait_for(Fut&& fut, std::chrono::duration<Rep, Period> timeout) {
     return detail::wait_for(no_wait_at_initial_suspend, std::forward<Fut>(fut), timeout);
 }
+
+// Like `wait_for()`, but a timeout is returned as `std::errc::timed_out` rather than thrown. Exceptions thrown by `fut`
+// itself still propagate.
+template<concepts::Awaitable Fut, typename Rep, typename Period>
+[[nodiscard("discard try_wait_for doesn't make sense")]]
+Task<Expected<AwaitResult<Fut>>> try_wait_for(Fut&& fut, std::chrono::duration<Rep, Period> timeout) {
+    return detail::try_wait_for(no_wait_at_initial_suspend, std::forward<Fut>(fut), timeout);
+}
 ASYNCIO_NS_END
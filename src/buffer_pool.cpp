@@ -0,0 +1,95 @@
+//
+// Created on 2026/10/18.
+//
+#include <asyncio/buffer_pool.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+ASYNCIO_NS_BEGIN
+
+namespace {
+using detail::BufferBlock;
+constexpr std::align_val_t block_align{alignof(BufferBlock)};
+
+size_t round_up(size_t n, size_t multiple) { return (n + multiple - 1) / multiple * multiple; }
+
+BufferBlock* new_block(std::byte* where, BufferPool* pool, size_t capacity, bool pooled) {
+    return new (where) BufferBlock{ .pool = pool, .next_free = nullptr, .capacity = capacity, .refs = 0,
+                                    .pooled = pooled };
+}
+} // namespace
+
+BufferLease::BufferLease(size_t size, char): BufferLease(get_buffer_pool().acquire(size)) {}
+
+void BufferLease::resize(size_t size) {
+    if (size > capacity()) [[unlikely]] {
+        throw std::length_error(fmt::format("BufferLease::resize: {} > capacity {}", size, capacity()));
+    }
+    size_ = size;
+}
+
+BufferLease BufferLease::share() const {
+    if (block_) { ++block_->refs; }
+    return BufferLease{block_, size_};
+}
+
+void BufferLease::reset() {
+    if (auto block = std::exchange(block_, nullptr); block && --block->refs == 0) {
+        block->pool->give_back(block);
+    }
+    size_ = 0;
+}
+
+BufferPool::BufferPool(size_t block_size, size_t blocks_per_slab)
+    : block_size_(round_up(std::max<size_t>(block_size, 1), alignof(BufferBlock))),
+      blocks_per_slab_(std::max<size_t>(blocks_per_slab, 1)) {}
+
+BufferPool::~BufferPool() {
+    for (auto slab : slabs_) { ::operator delete(slab, block_align); }
+}
+
+BufferLease BufferPool::acquire(size_t size) {
+    BufferBlock* block;
+    if (size > block_size_) {
+        const size_t capacity = round_up(size, alignof(BufferBlock));
+        block = new_block(static_cast<std::byte*>(::operator new(sizeof(BufferBlock) + capacity, block_align)),
+                          this, capacity, false);
+    } else {
+        if (! free_) {
+            const size_t stride = sizeof(BufferBlock) + block_size_;
+            auto slab = static_cast<std::byte*>(::operator new(stride * blocks_per_slab_, block_align));
+            slabs_.push_back(slab);
+            for (size_t i = blocks_per_slab_; i-- > 0; ) {
+                auto b = new_block(slab + i * stride, this, block_size_, true);
+                b->next_free = std::exchange(free_, b);
+            }
+            free_count_ += blocks_per_slab_;
+        }
+        block = std::exchange(free_, free_->next_free);
+        --free_count_;
+    }
+    block->refs = 1;
+    ++in_use_;
+    return BufferLease{block, size};
+}
+
+void BufferPool::give_back(BufferBlock* block) {
+    --in_use_;
+    if (block->pooled) {
+        block->next_free = std::exchange(free_, block);
+        ++free_count_;
+    } else {
+        ::operator delete(block, block_align);
+    }
+}
+
+BufferPool& get_buffer_pool() {
+    thread_local BufferPool pool;
+    return pool;
+}
+
+ASYNCIO_NS_END
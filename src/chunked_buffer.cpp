@@ -0,0 +1,154 @@
+//
+// Created on 2026/10/18.
+//
+#include <asyncio/chunked_buffer.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+ASYNCIO_NS_BEGIN
+
+namespace {
+// Free segments, by size class. Segment capacities are powers of 2 from AdaptiveReadSize::min_size up to max_size.
+constexpr unsigned min_shift = std::countr_zero(AdaptiveReadSize::min_size);
+constexpr unsigned max_shift = std::countr_zero(AdaptiveReadSize::max_size);
+constexpr size_t max_pooled_bytes = 4 * AdaptiveReadSize::max_size; // per size class
+
+struct SegmentPool {
+    std::array<std::vector<char*>, max_shift - min_shift + 1> free;
+    ~SegmentPool() {
+        for (auto& segments : free) {
+            for (char* data : segments) { delete[] data; }
+        }
+    }
+};
+
+SegmentPool& get_segment_pool() {
+    thread_local SegmentPool pool;
+    return pool;
+}
+
+size_t size_class(size_t capacity) {
+    capacity = std::clamp(capacity, AdaptiveReadSize::min_size, AdaptiveReadSize::max_size);
+    return std::bit_width(std::bit_ceil(capacity)) - 1 - min_shift;
+}
+} // namespace
+
+void AdaptiveReadSize::record(size_t nread) {
+    if (nread >= next()) {
+        index_ = std::min(index_ + 2, max_index);
+        shrink_pending_ = false;
+    } else if (index_ > 0 && nread <= next() / 2) {
+        if (shrink_pending_) { --index_; }
+        shrink_pending_ = ! shrink_pending_;
+    } else {
+        shrink_pending_ = false;
+    }
+}
+
+ChunkedBuffer::ChunkedBuffer(ChunkedBuffer&& other) noexcept
+    : segments_(std::move(other.segments_)), spare_(std::exchange(other.spare_, std::nullopt)),
+      size_(std::exchange(other.size_, 0)), read_size_(other.read_size_)
+{
+    other.segments_.clear();
+}
+
+ChunkedBuffer& ChunkedBuffer::operator=(ChunkedBuffer&& other) noexcept {
+    if (this != &other) {
+        clear();
+        segments_ = std::move(other.segments_);
+        other.segments_.clear();
+        spare_ = std::exchange(other.spare_, std::nullopt);
+        size_ = std::exchange(other.size_, 0);
+        read_size_ = other.read_size_;
+    }
+    return *this;
+}
+
+void ChunkedBuffer::append(std::span<const char> data) {
+    while (! data.empty()) {
+        if (segments_.empty() || segments_.back().size == segments_.back().capacity) {
+            segments_.push_back(acquire(data.size()));
+        }
+        auto& tail = segments_.back();
+        const size_t n = std::min(data.size(), tail.capacity - tail.size);
+        std::memcpy(tail.data + tail.size, data.data(), n);
+        tail.size += n;
+        size_ += n;
+        data = data.subspan(n);
+    }
+}
+
+void ChunkedBuffer::clear() {
+    for (auto& segment : segments_) { release(segment); }
+    segments_.clear();
+    if (spare_) { release(*std::exchange(spare_, std::nullopt)); }
+    size_ = 0;
+}
+
+size_t ChunkedBuffer::copy_to(std::span<char> out) const {
+    size_t copied = 0;
+    for (auto& segment : segments_) {
+        const size_t n = std::min(segment.size, out.size() - copied);
+        std::memcpy(out.data() + copied, segment.data, n);
+        copied += n;
+        if (copied == out.size()) { break; }
+    }
+    return copied;
+}
+
+std::span<const iovec> ChunkedBuffer::prepare() {
+    const size_t want = read_size_.next();
+    iov_count_ = 0;
+    tail_room_ = 0;
+    if (! segments_.empty() && segments_.back().size < segments_.back().capacity) {
+        auto& tail = segments_.back();
+        tail_room_ = tail.capacity - tail.size;
+        iov_[iov_count_++] = iovec{ .iov_base = tail.data + tail.size, .iov_len = tail_room_ };
+    }
+    if (tail_room_ < want) {
+        if (spare_ && spare_->capacity < want - tail_room_) { release(*std::exchange(spare_, std::nullopt)); }
+        if (! spare_) { spare_ = acquire(want - tail_room_); }
+        iov_[iov_count_++] = iovec{ .iov_base = spare_->data, .iov_len = spare_->capacity };
+    }
+    return {iov_, iov_count_};
+}
+
+void ChunkedBuffer::commit(size_t nread) {
+    read_size_.record(nread);
+    size_ += nread;
+    // the tail of the last segment is filled first, then the spare
+    const size_t into_tail = std::min(nread, std::exchange(tail_room_, 0));
+    if (into_tail > 0) { segments_.back().size += into_tail; }
+    if (nread > into_tail) {
+        spare_->size = nread - into_tail;
+        segments_.push_back(*std::exchange(spare_, std::nullopt));
+    }
+    iov_count_ = 0;
+}
+
+ChunkedBuffer::Segment ChunkedBuffer::acquire(size_t capacity) {
+    const size_t cls = size_class(capacity);
+    auto& free = get_segment_pool().free[cls];
+    capacity = AdaptiveReadSize::min_size << cls;
+    if (! free.empty()) {
+        char* data = free.back();
+        free.pop_back();
+        return Segment{data, capacity, 0};
+    }
+    return Segment{new char[capacity], capacity, 0};
+}
+
+void ChunkedBuffer::release(const Segment& segment) {
+    auto& free = get_segment_pool().free[size_class(segment.capacity)];
+    if ((free.size() + 1) * segment.capacity <= max_pooled_bytes) {
+        free.push_back(segment.data);
+    } else {
+        delete[] segment.data;
+    }
+}
+
+ASYNCIO_NS_END
@@ -0,0 +1,196 @@
+//
+// Created on 2026/10/18.
+//
+#include <asyncio/connection_pool.h>
+
+#include <asyncio/event_loop.h>
+#include <asyncio/finally.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+
+#include <sys/socket.h>
+
+ASYNCIO_NS_BEGIN
+
+namespace {
+std::string bucket_key(std::string_view host, uint16_t port) {
+    return fmt::format("{}:{}", host, port);
+}
+
+// An idle connection should have nothing to read: EOF means the peer went away, and unsolicited data means we
+// can't tell where the next response starts anymore.
+bool is_alive(const Stream& stream) {
+    if (stream.get_fd() < 0) { return false; }
+    char c;
+    ssize_t sz = ::recv(stream.get_fd(), &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return sz < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+} // namespace
+
+struct ConnectionPool::WaitAwaiter : NonCopyable {
+    explicit WaitAwaiter(Bucket& bucket): bucket_(bucket) {}
+    ~WaitAwaiter() {
+        if (waiting_) { std::erase(bucket_.waiters, handle_); }
+    }
+
+    constexpr bool await_ready() const noexcept { return false; }
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> continuation) noexcept {
+        continuation.promise().set_state(Handle::SUSPEND);
+        handle_ = &continuation.promise();
+        bucket_.waiters.push_back(handle_);
+        waiting_ = true;
+    }
+    void await_resume() noexcept { waiting_ = false; }
+
+    Bucket& bucket_;
+    CoroHandle* handle_{};
+    bool waiting_{false};
+};
+
+void ConnectionPool::Lease::release() {
+    if (auto pool = std::exchange(pool_, nullptr)) {
+        pool->give_back(*bucket_, std::move(stream_));
+        stream_.reset();
+    }
+}
+
+ConnectionPool::~ConnectionPool() {
+    background_.clear();
+}
+
+Task<ConnectionPool::Lease> ConnectionPool::acquire(std::string_view host, uint16_t port) {
+    auto& loop = get_event_loop();
+    const auto start = loop.time();
+    Bucket& b = bucket(host, port);
+    while (true) {
+        if (auto stream = take_idle(b)) {
+            ++stats_.hits;
+            record_wait(loop.time() - start);
+            warm_up_in_background(b);
+            co_return Lease{*this, b, std::move(*stream)};
+        }
+        if (b.total < options_.max_per_key) {
+            ++b.total;
+            bool counted = true;
+            // give the slot back if connecting fails, or we get cancelled meanwhile
+            finally { if (counted) { --b.total; wake_one(b); } };
+            auto stream = co_await open_connection(b.host, b.port, options_.connect);
+            counted = false;
+            ++stats_.misses;
+            record_wait(loop.time() - start);
+            co_return Lease{*this, b, std::move(stream)};
+        }
+        ++stats_.waits;
+        co_await WaitAwaiter{b};
+    }
+}
+
+Task<> ConnectionPool::warm_up(std::string_view host, uint16_t port) {
+    co_await warm_up(bucket(host, port));
+}
+
+size_t ConnectionPool::idle_count(std::string_view host, uint16_t port) const {
+    auto b = find_bucket(host, port);
+    return b ? b->idle.size() : 0;
+}
+
+size_t ConnectionPool::connection_count(std::string_view host, uint16_t port) const {
+    auto b = find_bucket(host, port);
+    return b ? b->total : 0;
+}
+
+ConnectionPool::Bucket& ConnectionPool::bucket(std::string_view host, uint16_t port) {
+    auto [iter, inserted] = buckets_.try_emplace(bucket_key(host, port));
+    if (inserted) {
+        iter->second.host = host;
+        iter->second.port = port;
+    }
+    return iter->second;
+}
+
+const ConnectionPool::Bucket* ConnectionPool::find_bucket(std::string_view host, uint16_t port) const {
+    auto iter = buckets_.find(bucket_key(host, port));
+    return iter != buckets_.end() ? &iter->second : nullptr;
+}
+
+std::optional<Stream> ConnectionPool::take_idle(Bucket& b) {
+    const auto now = get_event_loop().time();
+    auto drop = [&] { ++stats_.dropped; --b.total; };
+    // oldest are at the front
+    while (! b.idle.empty() && now - b.idle.front().since >= options_.idle_timeout) {
+        b.idle.pop_front();
+        drop();
+    }
+    // hand out the most recently used, it's the most likely to be alive and warm
+    while (! b.idle.empty()) {
+        std::optional<Stream> stream;
+        stream.emplace(std::move(b.idle.back().stream));
+        b.idle.pop_back();
+        if (is_alive(*stream)) { return stream; }
+        drop();
+    }
+    return std::nullopt;
+}
+
+void ConnectionPool::give_back(Bucket& b, std::optional<Stream> stream) {
+    if (stream && stream->get_fd() >= 0) {
+        b.idle.push_back(Idle{std::move(*stream), get_event_loop().time()});
+    } else {
+        --b.total;
+    }
+    wake_one(b);
+}
+
+void ConnectionPool::wake_one(Bucket& b) {
+    if (! b.waiters.empty()) {
+        auto waiter = b.waiters.front();
+        b.waiters.pop_front();
+        get_event_loop().call_soon(*waiter);
+    }
+}
+
+void ConnectionPool::record_wait(MSDuration waited) {
+    stats_.total_wait += waited;
+    stats_.max_wait = std::max(stats_.max_wait, waited);
+}
+
+void ConnectionPool::warm_up_in_background(Bucket& b) {
+    // garbage collect
+    std::erase_if(background_, [](auto& task) { return task.done(); });
+    if (! b.warming && b.idle.size() < options_.min_idle_per_key && b.total < options_.max_per_key) {
+        background_.emplace_back(schedule_task(warm_up(b)));
+    }
+}
+
+Task<> ConnectionPool::warm_up(Bucket& b) {
+    auto open_idle = [this](Bucket& b) -> Task<> {
+        bool counted = true;
+        // give the slot back unless the connection made it to `idle`: if connecting fails, or we get cancelled
+        finally {
+            if (counted) { --b.total; }
+            wake_one(b);
+        };
+        try {
+            auto stream = co_await open_connection(b.host, b.port, options_.connect);
+            b.idle.push_back(Idle{std::move(stream), get_event_loop().time()});
+            counted = false;
+        } catch (const std::exception&) {
+            // skipped, the next acquire() or warm up will try again
+        }
+    };
+    b.warming = true;
+    finally { b.warming = false; };
+    std::list<ScheduledTask<Task<>>> opening;
+    while (b.idle.size() + opening.size() < options_.min_idle_per_key && b.total < options_.max_per_key) {
+        ++b.total;
+        opening.emplace_back(schedule_task(open_idle(b)));
+    }
+    for (auto& task : opening) { co_await task; }
+}
+
+ASYNCIO_NS_END
@@ -0,0 +1,255 @@
+//
+// Created on 2026/10/18.
+//
+#include <asyncio/datagram.h>
+
+#include <asyncio/resolver.h>
+
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+ASYNCIO_NS_BEGIN
+
+namespace {
+#if defined(__linux__)
+constexpr size_t max_batch = UIO_MAXIOV;
+#else
+constexpr size_t max_batch = 1024;
+
+// recvmmsg() and sendmmsg() are Linux only: one system call per datagram elsewhere
+struct mmsghdr {
+    msghdr msg_hdr;
+    unsigned int msg_len;
+};
+
+int recvmmsg(int fd, mmsghdr* msgs, unsigned int count, int flags, timespec*) {
+    unsigned int i = 0;
+    for (; i < count; ++i) {
+        ssize_t const sz = ::recvmsg(fd, &msgs[i].msg_hdr, flags);
+        if (sz < 0) { return i > 0 ? int(i) : -1; }
+        msgs[i].msg_len = unsigned(sz);
+    }
+    return int(i);
+}
+
+int sendmmsg(int fd, mmsghdr* msgs, unsigned int count, int flags) {
+    unsigned int i = 0;
+    for (; i < count; ++i) {
+        ssize_t const sz = ::sendmsg(fd, &msgs[i].msg_hdr, flags);
+        if (sz < 0) { return i > 0 ? int(i) : -1; }
+        msgs[i].msg_len = unsigned(sz);
+    }
+    return int(i);
+}
+#endif
+
+// room for the segment size that comes with UDP_GRO (an int) or goes with UDP_SEGMENT (a uint16_t)
+constexpr size_t control_size = CMSG_SPACE(sizeof(int));
+
+size_t batch_size(size_t wanted) { return std::clamp<size_t>(wanted, 1, max_batch); }
+
+std::error_code last_error() { return std::make_error_code(static_cast<std::errc>(errno)); }
+
+bool would_block() { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+
+Task<DatagramEndpoint> open_endpoint(std::string_view host, uint16_t port, DatagramOptions options, bool connect) {
+    addrinfo hints{ .ai_flags = connect ? 0 : AI_PASSIVE, .ai_family = AF_UNSPEC, .ai_socktype = SOCK_DGRAM };
+    auto addrs = co_await get_resolver().resolve(host, port, hints);
+    std::error_code error = std::make_error_code(std::errc::address_not_available);
+    for (const auto& ai : addrs) {
+        int fd = ::socket(ai.family, SOCK_DGRAM | socket::NonBlockFlag | socket::CloExecFlag, 0);
+        if (fd == -1) {
+            error = last_error();
+            continue;
+        }
+        socket::set_blocking(fd, false);
+        socket::set_cloexec(fd);
+#if defined(SO_REUSEPORT)
+        int yes = 1;
+        if (options.reuse_port) { ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes)); }
+#endif
+        int const rc = connect ? ::connect(fd, ai.sockaddr_ptr(), ai.addrlen) : ::bind(fd, ai.sockaddr_ptr(), ai.addrlen);
+        if (rc == 0) { co_return DatagramEndpoint{fd, options}; }
+        error = last_error();
+        ::close(fd);
+    }
+    throw std::system_error(error);
+}
+} // namespace
+
+DatagramEndpoint::DatagramEndpoint(int fd, DatagramOptions options)
+    : stream_(fd), options_(options)
+{
+#if defined(__linux__) && defined(UDP_SEGMENT) && defined(UDP_GRO)
+    int yes = 1;
+    if (options_.gro && ::setsockopt(fd, IPPROTO_UDP, UDP_GRO, &yes, sizeof(yes)) != 0) { options_.gro = false; }
+#else
+    options_.gro = options_.gso = false;
+#endif
+}
+
+// Where recvmmsg() puts a batch: `count` slots of `size` bytes, with their headers
+struct DatagramEndpoint::RecvScratch {
+    size_t count{0};
+    size_t size{0};
+    std::vector<std::byte> data;
+    std::vector<sockaddr_storage> addrs;
+    std::vector<mmsghdr> msgs;
+    std::vector<iovec> iovs;
+    std::vector<char> control;
+
+    void reserve(size_t new_count, size_t new_size, bool gro) {
+        if (new_count <= count && new_size == size && control.size() == (gro ? count * control_size : 0)) { return; }
+        count = std::max(count, new_count);
+        size = new_size;
+        data.resize(count * size);
+        addrs.resize(count);
+        msgs.resize(count);
+        iovs.resize(count);
+        control.assign(gro ? count * control_size : 0, 0);
+    }
+};
+
+DatagramEndpoint::DatagramEndpoint(DatagramEndpoint&&) = default;
+DatagramEndpoint::~DatagramEndpoint() = default;
+
+Task<std::vector<Datagram>> DatagramEndpoint::recv_batch(size_t max_count)
+{
+    auto datagrams = co_await try_recv_batch(max_count);
+    co_return std::move(datagrams).value();
+}
+
+Task<Expected<std::vector<Datagram>>> DatagramEndpoint::try_recv_batch(size_t max_count)
+{
+    size_t const count = batch_size(max_count ? max_count : options_.batch_size);
+    BufferPool& pool = get_buffer_pool();
+    size_t const size = options_.max_datagram_size ? options_.max_datagram_size : pool.block_size();
+    while (true) {
+        // the endpoint sets no timeouts, so this can't throw
+        co_await stream_.wait_readable();
+        // from here on there is no suspending until the batch is copied out, so concurrent receivers can share it
+        if (! scratch_) { scratch_ = std::make_unique<RecvScratch>(); }
+        RecvScratch& scratch = *scratch_;
+        scratch.reserve(count, size, options_.gro);
+        for (size_t i = 0; i < count; ++i) {
+            scratch.iovs[i] = { .iov_base = &scratch.data[i * size], .iov_len = size };
+            msghdr& hdr = scratch.msgs[i].msg_hdr;
+            hdr = {};
+            hdr.msg_name = &scratch.addrs[i];
+            hdr.msg_namelen = sizeof(sockaddr_storage);
+            hdr.msg_iov = &scratch.iovs[i];
+            hdr.msg_iovlen = 1;
+            if (options_.gro) {
+                hdr.msg_control = &scratch.control[i * control_size];
+                hdr.msg_controllen = control_size;
+            }
+        }
+        int const n = ::recvmmsg(get_fd(), scratch.msgs.data(), unsigned(count), 0, nullptr);
+        if (n < 0) {
+            if (would_block()) { continue; }
+            co_return last_error();
+        }
+        std::vector<Datagram> datagrams(static_cast<size_t>(n));
+        for (size_t i = 0; i < size_t(n); ++i) {
+            Datagram& d = datagrams[i];
+            size_t const len = scratch.msgs[i].msg_len;
+            d.data = pool.acquire(len);
+            std::memcpy(d.data.data(), &scratch.data[i * size], len);
+            d.addr = scratch.addrs[i];
+            d.addrlen = scratch.msgs[i].msg_hdr.msg_namelen;
+#if defined(__linux__) && defined(UDP_GRO)
+            msghdr& hdr = scratch.msgs[i].msg_hdr;
+            for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+                if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO) {
+                    int segment_size = 0;
+                    std::memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+                    d.segment_size = uint16_t(segment_size);
+                }
+            }
+#endif
+        }
+        co_return std::move(datagrams);
+    }
+}
+
+Task<size_t> DatagramEndpoint::send_batch(std::span<const Datagram> datagrams)
+{
+    auto sent = co_await try_send_batch(datagrams);
+    co_return sent.value();
+}
+
+Task<Expected<size_t>> DatagramEndpoint::try_send_batch(std::span<const Datagram> datagrams)
+{
+    // Without GSO, a Datagram with a segment size goes out as one message per segment. The position in `datagrams`
+    // is then a Datagram and an offset into it.
+    struct Position { size_t index; size_t offset; };
+    auto segment = [&](Position pos) {
+        const Datagram& d = datagrams[pos.index];
+        size_t const left = d.data.size() - pos.offset;
+        return ! options_.gso && d.segment_size ? std::min<size_t>(left, d.segment_size) : left;
+    };
+
+    size_t const count = batch_size(options_.batch_size);
+    std::vector<mmsghdr> msgs(count);
+    std::vector<iovec> iovs(count);
+    std::vector<char> control(options_.gso ? count * control_size : 0);
+    std::vector<Position> starts(count + 1);
+    Position pos{0, 0};
+    while (pos.index < datagrams.size()) {
+        size_t batch = 0;
+        for (Position next = pos; batch < count && next.index < datagrams.size(); ++batch) {
+            const Datagram& d = datagrams[next.index];
+            size_t const len = segment(next);
+            starts[batch] = next;
+            iovs[batch] = { .iov_base = const_cast<char*>(d.data.data()) + next.offset, .iov_len = len };
+            msghdr& hdr = msgs[batch].msg_hdr;
+            hdr = {};
+            hdr.msg_name = d.addrlen ? const_cast<sockaddr_storage*>(&d.addr) : nullptr;
+            hdr.msg_namelen = d.addrlen;
+            hdr.msg_iov = &iovs[batch];
+            hdr.msg_iovlen = 1;
+#if defined(__linux__) && defined(UDP_SEGMENT)
+            if (options_.gso && d.segment_size && d.data.size() > d.segment_size) {
+                hdr.msg_control = &control[batch * control_size];
+                hdr.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+                cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+                cmsg->cmsg_level = IPPROTO_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                std::memcpy(CMSG_DATA(cmsg), &d.segment_size, sizeof(uint16_t));
+            }
+#endif
+            next.offset += len;
+            if (next.offset >= d.data.size()) { next = {next.index + 1, 0}; }
+            starts[batch + 1] = next;
+        }
+        int const n = ::sendmmsg(get_fd(), msgs.data(), unsigned(batch), 0);
+        if (n < 0) {
+            if (! would_block()) { co_return last_error(); }
+            co_await stream_.wait_writable();
+            continue;
+        }
+        pos = starts[size_t(n)];
+    }
+    co_return datagrams.size();
+}
+
+Task<DatagramEndpoint> create_datagram_endpoint(std::string_view host, uint16_t port, DatagramOptions options)
+{
+    co_return co_await open_endpoint(host, port, options, false);
+}
+
+Task<DatagramEndpoint> connect_datagram_endpoint(std::string_view host, uint16_t port, DatagramOptions options)
+{
+    co_return co_await open_endpoint(host, port, options, true);
+}
+
+ASYNCIO_NS_END
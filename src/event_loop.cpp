@@ -6,6 +6,7 @@
 #include <chrono>
 #include <memory>
 #include <optional>
+#include <system_error>
 
 namespace ranges = std::ranges;
 
@@ -34,13 +35,31 @@ void EventLoop::cleanup_delayed_call() {
     }
 }
 
-void EventLoop::run_once() {
-    std::optional<MSDuration> timeout;
-    if (! ready_.empty()) {
-        timeout.emplace(0);
-    } else if (! schedule_.empty()) {
+auto EventLoop::next_timeout() -> std::optional<MSDuration> {
+    if (! ready_.empty()) { return MSDuration(0); }
+    cleanup_delayed_call();
+    if (! schedule_.empty()) {
         auto&& [when, _] = schedule_[0];
-        timeout = std::max(when - time(), MSDuration(0));
+        return std::max(when - time(), MSDuration(0));
+    }
+    return std::nullopt;
+}
+
+size_t EventLoop::poll(MSDuration timeout) {
+    return run_once(std::max(timeout, MSDuration(0)));
+}
+
+void EventLoop::run_for(MSDuration duration) {
+    const auto deadline = time() + duration;
+    for (auto now = time(); now < deadline; now = time()) {
+        run_once(deadline - now);
+    }
+}
+
+size_t EventLoop::run_once(std::optional<MSDuration> max_wait) {
+    std::optional<MSDuration> timeout = next_timeout();
+    if (max_wait && (! timeout || *timeout > *max_wait)) {
+        timeout = max_wait;
     }
 
     auto event_lists = selector_.select(timeout.has_value() ? timeout->count() : -1);
@@ -57,6 +76,7 @@ void EventLoop::run_once() {
         schedule_.pop_back();
     }
 
+    size_t nrun = 0;
     for (size_t ntodo = ready_.size(), i = 0; i < ntodo; ++i) {
         auto [handle_id, handle] = ready_.front(); ready_.pop();
         if (auto iter = cancelled_.find(handle_id); iter != cancelled_.end()) {
@@ -64,10 +84,46 @@ void EventLoop::run_once() {
         } else {
             handle->set_state(Handle::UNSCHEDULED);
             handle->run();
+            ++nrun;
         }
     }
 
     cleanup_delayed_call();
+    removed_watchers_.clear();
+    return nrun;
+}
+
+EventLoop::FdWatcher::FdWatcher(int fd, Event::Flags flags, std::function<void()> callback)
+    : event{ .fd = fd, .flags = flags }, callback(std::move(callback)) {
+    event.handle_info = { .id = get_handle_id(), .handle = this };
+}
+
+void EventLoop::FdWatcher::run() {
+    // the callback may have been removed after the selector reported the fd, in the same loop tick
+    if (! removed) { callback(); }
+}
+
+void EventLoop::add_watcher(FdWatchers& watchers, int fd, Event::Flags flags, std::function<void()> callback) {
+    remove_watcher(watchers, fd);
+    // one registration per fd and direction: a Stream or a wait on it would stop getting its events
+    if (selector_.is_registered(fd, flags)) {
+        throw std::system_error(std::make_error_code(std::errc::device_or_resource_busy));
+    }
+    auto watcher = std::make_unique<FdWatcher>(fd, flags, std::move(callback));
+    if (auto error = selector_.register_event(watcher->event)) { throw std::system_error(error); }
+    watchers.emplace(fd, std::move(watcher));
+}
+
+bool EventLoop::remove_watcher(FdWatchers& watchers, int fd) {
+    auto iter = watchers.find(fd);
+    if (iter == watchers.end()) { return false; }
+    auto watcher = std::move(iter->second);
+    watchers.erase(iter);
+    selector_.remove_event(watcher->event);
+    // not freed yet: it may be running right now, or be queued to
+    watcher->removed = true;
+    removed_watchers_.push_back(std::move(watcher));
+    return true;
 }
 
 std::atomic<HandleId> Handle::handle_id_generation_ = 0;
@@ -0,0 +1,157 @@
+//
+// Created on 2026/10/18.
+//
+#include <asyncio/memory_stream.h>
+#include <asyncio/event_loop.h>
+#include <asyncio/handle.h>
+
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+ASYNCIO_NS_BEGIN
+
+// One direction: a ring buffer, and whoever waits on either end of it.
+struct MemoryStream::Pipe {
+    std::vector<std::byte> ring;
+    size_t begin{0}; // of the unread data
+    size_t size{0};
+    bool write_closed{false}; // the reader gets EOF once it read everything
+    bool read_closed{false};  // writes fail with broken_pipe
+    CoroHandle* reader{};
+    CoroHandle* writer{};
+
+    size_t room() const { return write_closed || read_closed ? 0 : ring.size() - size; }
+
+    static void wake(CoroHandle*& waiter) {
+        if (auto handle = std::exchange(waiter, nullptr)) { get_event_loop().call_soon(*handle); }
+    }
+};
+
+struct MemoryStream::Shared {
+    Pipe pipes[2]; // the first stream writes to pipes[0]
+};
+
+// Parks the coroutine in `waiter` until the other end wakes it.
+struct MemoryStream::WaitAwaiter : NonCopyable {
+    explicit WaitAwaiter(CoroHandle*& waiter): waiter_(waiter) {}
+    ~WaitAwaiter() {
+        if (waiter_ == handle_) { waiter_ = nullptr; } // cancelled while waiting
+    }
+
+    constexpr bool await_ready() const noexcept { return false; }
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> continuation) noexcept {
+        continuation.promise().set_state(Handle::SUSPEND);
+        handle_ = &continuation.promise();
+        waiter_ = handle_;
+    }
+    void await_resume() noexcept { }
+
+    CoroHandle*& waiter_;
+    CoroHandle* handle_{};
+};
+
+std::pair<MemoryStream, MemoryStream> memory_stream_pair(size_t capacity) {
+    auto shared = std::make_shared<MemoryStream::Shared>();
+    for (auto& pipe : shared->pipes) { pipe.ring.resize(std::max<size_t>(capacity, 1)); }
+    return {MemoryStream{shared, true}, MemoryStream{shared, false}};
+}
+
+MemoryStream::~MemoryStream() { close(); }
+
+MemoryStream::Pipe& MemoryStream::rx() const { return shared_->pipes[first_ ? 1 : 0]; }
+MemoryStream::Pipe& MemoryStream::tx() const { return shared_->pipes[first_ ? 0 : 1]; }
+
+void MemoryStream::close() {
+    if (! shared_) { return; }
+    shutdown(SHUT_RDWR);
+    shared_.reset();
+}
+
+void MemoryStream::shutdown(int how) {
+    if (! shared_) { return; }
+    if (how == SHUT_RD || how == SHUT_RDWR) {
+        Pipe& in = rx();
+        in.read_closed = true;
+        in.begin = in.size = 0;
+        Pipe::wake(in.writer);
+        Pipe::wake(in.reader);
+    }
+    if (how == SHUT_WR || how == SHUT_RDWR) {
+        Pipe& out = tx();
+        out.write_closed = true;
+        Pipe::wake(out.reader);
+        Pipe::wake(out.writer);
+    }
+}
+
+size_t MemoryStream::available() const { return shared_ ? rx().size : 0; }
+
+Task<> MemoryStream::wait_readable() {
+    auto shared = shared_; // kept alive while we wait, even if both ends are closed meanwhile
+    if (! shared) { throw std::system_error(std::make_error_code(std::errc::bad_file_descriptor)); }
+    Pipe& in = rx();
+    if (in.size == 0 && ! in.write_closed && ! in.read_closed) { co_await WaitAwaiter{in.reader}; }
+}
+
+Task<> MemoryStream::wait_writable() {
+    auto shared = shared_;
+    if (! shared) { throw std::system_error(std::make_error_code(std::errc::bad_file_descriptor)); }
+    Pipe& out = tx();
+    if (out.room() == 0 && ! out.write_closed && ! out.read_closed) { co_await WaitAwaiter{out.writer}; }
+}
+
+Task<Expected<size_t>> MemoryStream::read_bytes(std::span<std::byte> buffer, bool fill_buffer) {
+    auto shared = shared_;
+    if (! shared) [[unlikely]] { co_return std::make_error_code(std::errc::bad_file_descriptor); }
+    Pipe& in = rx();
+    size_t nread = 0;
+    while (nread < buffer.size()) {
+        if (in.size > 0) {
+            size_t const n = std::min(in.size, buffer.size() - nread);
+            size_t const first = std::min(n, in.ring.size() - in.begin);
+            std::memcpy(buffer.data() + nread, in.ring.data() + in.begin, first);
+            std::memcpy(buffer.data() + nread + first, in.ring.data(), n - first);
+            in.begin = (in.begin + n) % in.ring.size();
+            in.size -= n;
+            nread += n;
+            Pipe::wake(in.writer);
+            if (! fill_buffer) { break; }
+            continue;
+        }
+        if (in.write_closed || in.read_closed) { break; } // EOF
+        co_await WaitAwaiter{in.reader};
+        if (! shared_) [[unlikely]] { co_return std::make_error_code(std::errc::bad_file_descriptor); }
+    }
+    co_return nread;
+}
+
+Task<Expected<void>> MemoryStream::write_bytes(std::span<const std::byte> bytes) {
+    auto shared = shared_;
+    if (! shared) [[unlikely]] { co_return std::make_error_code(std::errc::bad_file_descriptor); }
+    Pipe& out = tx();
+    while (! bytes.empty()) {
+        if (out.write_closed || out.read_closed) [[unlikely]] {
+            co_return std::make_error_code(std::errc::broken_pipe);
+        }
+        size_t const room = out.room();
+        if (room == 0) {
+            co_await WaitAwaiter{out.writer};
+            if (! shared_) [[unlikely]] { co_return std::make_error_code(std::errc::bad_file_descriptor); }
+            continue;
+        }
+        size_t const n = std::min(room, bytes.size());
+        size_t const end = (out.begin + out.size) % out.ring.size();
+        size_t const first = std::min(n, out.ring.size() - end);
+        std::memcpy(out.ring.data() + end, bytes.data(), first);
+        std::memcpy(out.ring.data(), bytes.data() + first, n - first);
+        out.size += n;
+        bytes = bytes.subspan(n);
+        Pipe::wake(out.reader);
+    }
+    co_return Expected<void>{};
+}
+
+ASYNCIO_NS_END
@@ -3,21 +3,41 @@
 #include <asyncio/open_connection.h>
 
 #include <asyncio/finally.h>
+#include <asyncio/resolver.h>
+#include <asyncio/schedule_task.h>
 #include <asyncio/selector/event.h>
 
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <optional>
+#include <stdexcept>
 #include <system_error>
+#include <utility>
 
 #include <fcntl.h>
+#include <netinet/in.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#if defined(__linux__) && !defined(IP_LOCAL_PORT_RANGE) /* linux >= 6.3, not yet in every libc */
+#define IP_LOCAL_PORT_RANGE 51
+#endif
 
 ASYNCIO_NS_BEGIN
 namespace detail {
-Task<bool> connect(int fd, const sockaddr *addr, socklen_t len) {
+// Returns an empty error_code once connected, or why the connection failed. Refused connections are routine, so
+// they are not thrown.
+Task<std::error_code> connect(int fd, const sockaddr *addr, socklen_t len) {
     int rc = ::connect(fd, addr, len);
-    if (rc == 0) { co_return true; }
+    if (rc == 0) { co_return std::error_code{}; }
     if (rc < 0 && errno != EINPROGRESS) {
-        throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+        co_return std::make_error_code(static_cast<std::errc>(errno));
     }
     Event ev { .fd = fd, .flags = Event::Flags::EVENT_WRITE };
     auto& loop = get_event_loop();
@@ -27,40 +47,273 @@ Task<bool> connect(int fd, const sockaddr *addr, socklen_t len) {
     socklen_t result_len = sizeof(result);
     if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &result, &result_len) < 0) {
         // error, fail somehow, close socket
-        co_return false;
+        co_return std::make_error_code(static_cast<std::errc>(errno));
     }
-    co_return result == 0;
+    co_return std::make_error_code(static_cast<std::errc>(result));
 }
-} // namespace detail
 
-Task<Stream> open_connection(std::string_view ip, uint16_t port) {
-    addrinfo hints { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM };
-    addrinfo *server_info {nullptr};
-    auto service = std::to_string(port);
-    // TODO: getaddrinfo is a blocking api
-    if (int rv = getaddrinfo(ip.data(), service.c_str(), &hints, &server_info); rv != 0) {
-        throw std::system_error(std::make_error_code(std::errc::address_not_available));
+// Interleaves address families, keeping the resolver's order within each family (RFC 8305 section 4).
+std::vector<AddrInfo> interleave_families(std::vector<AddrInfo> addrs) {
+    if (addrs.empty()) { return addrs; }
+    std::vector<AddrInfo> first, other;
+    for (auto& ai : addrs) {
+        (ai.family == addrs.front().family ? first : other).push_back(ai);
+    }
+    std::vector<AddrInfo> result;
+    result.reserve(addrs.size());
+    for (size_t i = 0; i < std::max(first.size(), other.size()); ++i) {
+        if (i < first.size()) { result.push_back(first[i]); }
+        if (i < other.size()) { result.push_back(other[i]); }
     }
-    finally { freeaddrinfo(server_info); };
+    return result;
+}
 
-    int sockfd = -1;
-    for (auto p = server_info; p != nullptr; p = p->ai_next) {
-        if ((sockfd = ::socket(p->ai_family, p->ai_socktype | socket::NonBlockFlag, p->ai_protocol)) == -1) {
-            continue;
+namespace {
+// Picks the next of `local_addrs` with the address family `family`, round-robin.
+std::optional<AddrInfo> pick_local_addr(int family, const std::vector<std::string>& local_addrs) {
+    if (local_addrs.empty()) { return std::nullopt; }
+    auto matches = [family](const std::string& addr) {
+        return (addr.find(':') != std::string::npos) == (family == AF_INET6);
+    };
+    const auto count = size_t(std::ranges::count_if(local_addrs, matches));
+    if (count == 0) {
+        throw std::system_error(std::make_error_code(std::errc::address_family_not_supported));
+    }
+    thread_local size_t round_robin = 0;
+    size_t n = round_robin++ % count;
+    for (const auto& addr : local_addrs) {
+        if (! matches(addr) || n-- > 0) { continue; }
+        addrinfo hints { .ai_flags = AI_NUMERICHOST | AI_PASSIVE, .ai_family = family, .ai_socktype = SOCK_STREAM };
+        std::vector<AddrInfo> result;
+        if (int rv = Resolver::system_lookup(addr, "0", hints, result); rv != 0 || result.empty()) {
+            throw std::system_error(std::make_error_code(std::errc::address_not_available),
+                                    fmt::format("{}: {}", addr, gai_strerror(rv)));
+        }
+        return result.front();
+    }
+    return std::nullopt;
+}
+
+void set_port(AddrInfo& ai, uint16_t port) {
+    auto *bytes = reinterpret_cast<std::byte *>(&ai.addr); // Prevent C++ UB, signal compiler about aliasing.
+    if (ai.family == AF_INET) {
+        reinterpret_cast<sockaddr_in *>(bytes)->sin_port = htons(port);
+    } else {
+        reinterpret_cast<sockaddr_in6 *>(bytes)->sin6_port = htons(port);
+    }
+}
+
+AddrInfo any_addr(int family) {
+    AddrInfo ai{ .family = family, .socktype = SOCK_STREAM };
+    ai.addrlen = family == AF_INET ? sizeof(sockaddr_in) : sizeof(sockaddr_in6);
+    ai.addr.ss_family = sa_family_t(family); // the rest is zero, i.e. INADDR_ANY / in6addr_any
+    return ai;
+}
+
+void throw_errno() {
+    throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+}
+} // namespace
+
+// Applies the source address & port settings of `options` to `fd`, before it connects to an address of `family`.
+void bind_local(int fd, int family, const ConnectOptions& options) {
+    std::optional<AddrInfo> local = pick_local_addr(family, options.local_addrs);
+    const auto [first_port, last_port] = options.local_port_range;
+    const bool port_range = first_port != 0 || last_port != 0;
+    if (! local && ! port_range) { return; }
+
+    int yes = 1;
+    if (options.reuse_addr && setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) != 0) { throw_errno(); }
+
+    bool range_set = ! port_range;
+#if defined(IP_LOCAL_PORT_RANGE)
+    if (port_range) {
+        uint32_t range = uint32_t(last_port) << 16 | first_port;
+        range_set = setsockopt(fd, IPPROTO_IP, IP_LOCAL_PORT_RANGE, &range, sizeof(range)) == 0;
+    }
+#endif
+    if (range_set) {
+        if (! local) { return; } // connect() picks the port, from the range
+#if defined(IP_BIND_ADDRESS_NO_PORT)
+        if (options.bind_address_no_port) {
+            setsockopt(fd, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, &yes, sizeof(yes));
+        }
+#endif
+        if (::bind(fd, local->sockaddr_ptr(), local->addrlen) != 0) { throw_errno(); }
+        return;
+    }
+
+    // the kernel can't restrict the ports for us, pick them from the range by hand
+    if (! local) { local = any_addr(family); }
+    constexpr uint32_t max_tries = 64;
+    thread_local uint32_t next_port = 0;
+    const uint32_t span = uint32_t(last_port) - first_port + 1;
+    for (uint32_t i = 0; i < std::min(span, max_tries); ++i) {
+        set_port(*local, uint16_t(first_port + next_port++ % span));
+        if (::bind(fd, local->sockaddr_ptr(), local->addrlen) == 0) { return; }
+        if (errno != EADDRINUSE) { throw_errno(); }
+    }
+    throw std::system_error(std::make_error_code(std::errc::address_in_use));
+}
+
+// Happy Eyeballs bookkeeping: the attempts report back here, and wake up open_connection() which is waiting for
+// either an attempt to finish, or the connection attempt delay to run out.
+struct ConnectRace : NonCopyable {
+    explicit ConnectRace(const ConnectOptions& options): options_(options) {}
+    ~ConnectRace() { if (winner_fd_ != -1) { ::close(winner_fd_); } }
+
+    Task<> attempt(AddrInfo ai) {
+        if (int fd = co_await try_connect(ai); fd != -1) {
+            if (winner_fd_ == -1) { winner_fd_ = fd; }
+            else { ::close(fd); }
+        }
+        --running_;
+        wake();
+    }
+
+    struct WaitAwaiter : NonCopyable {
+        WaitAwaiter(ConnectRace& race, std::optional<std::chrono::milliseconds> timeout)
+            : race_(race), timeout_(timeout) {}
+        constexpr bool await_ready() const noexcept { return false; }
+        template<typename Promise>
+        void await_suspend(std::coroutine_handle<Promise> continuation) noexcept {
+            continuation.promise().set_state(Handle::SUSPEND);
+            race_.waiter_ = &continuation.promise();
+            if (timeout_) {
+                timer_.armed_ = true;
+                get_event_loop().call_later(*timeout_, timer_);
+            }
+        }
+        constexpr void await_resume() const noexcept {}
+        ~WaitAwaiter() {
+            if (timer_.armed_) { get_event_loop().cancel_handle(timer_); }
+        }
+
+        struct Timer : Handle {
+            explicit Timer(ConnectRace& race): race_(race) {}
+            void run() override final {
+                armed_ = false;
+                race_.wake();
+            }
+            ConnectRace& race_;
+            bool armed_{false};
+        };
+
+        ConnectRace& race_;
+        std::optional<std::chrono::milliseconds> timeout_;
+        Timer timer_{race_};
+    };
+
+    // Resumes the caller as soon as an attempt finishes, or after `timeout` if there is one.
+    WaitAwaiter wait(std::optional<std::chrono::milliseconds> timeout) { return WaitAwaiter{*this, timeout}; }
+
+    void started() { ++running_; }
+    size_t running() const { return running_; }
+    int winner_fd() const { return winner_fd_; }
+    int release_winner() { return std::exchange(winner_fd_, -1); }
+    // Why the most recently failed attempt failed.
+    std::error_code error() const { return error_; }
+
+private:
+    Task<int> try_connect(const AddrInfo& ai) {
+        int sockfd = ::socket(ai.family, ai.socktype | socket::NonBlockFlag | socket::CloExecFlag, ai.protocol);
+        if (sockfd == -1) {
+            error_ = std::make_error_code(static_cast<std::errc>(errno));
+            co_return -1;
         }
         socket::set_blocking(sockfd, false);
-        bool ok = false;
-        finally { if (!ok) { ::close(sockfd); sockfd = -1; } };
-        if (co_await detail::connect(sockfd, p->ai_addr, p->ai_addrlen)) {
-            ok = true;
-            break;
+        socket::set_cloexec(sockfd);
+        // also runs when the attempt is cancelled while connecting
+        finally { if (sockfd != -1) { ::close(sockfd); } };
+        try {
+            bind_local(sockfd, ai.family, options_);
+        } catch (const std::system_error& e) {
+            error_ = e.code();
+            co_return -1;
+        }
+        std::error_code error = co_await detail::connect(sockfd, ai.sockaddr_ptr(), ai.addrlen);
+        if (! error) { co_return std::exchange(sockfd, -1); }
+        error_ = error;
+        co_return -1;
+    }
+
+    void wake() {
+        if (auto waiter = std::exchange(waiter_, nullptr)) {
+            get_event_loop().call_soon(*waiter);
         }
     }
-    if (sockfd == -1) {
-        throw std::system_error(std::make_error_code(std::errc::address_not_available));
+
+    const ConnectOptions& options_;
+    CoroHandle* waiter_{};
+    size_t running_{0};
+    int winner_fd_{-1};
+    std::error_code error_{std::make_error_code(std::errc::address_not_available)}; // for lack of addresses
+};
+} // namespace detail
+
+Task<Stream> open_connection(std::string_view ip, uint16_t port, ConnectOptions options) {
+    co_return co_await open_connection(co_await get_resolver().resolve(ip, port), options);
+}
+
+Task<Stream> open_connection(std::vector<AddrInfo> addrs, ConnectOptions options) {
+    if (options.local_port_range.first > options.local_port_range.second) {
+        throw std::invalid_argument("open_connection: bad local_port_range");
+    }
+    auto stream = co_await try_open_connection(std::move(addrs), std::move(options));
+    co_return std::move(stream).value();
+}
+
+Task<Expected<Stream>> try_open_connection(std::string_view ip, uint16_t port, ConnectOptions options) {
+    auto addrs = co_await get_resolver().try_resolve(ip, port);
+    if (! addrs) { co_return addrs.error(); }
+    co_return co_await try_open_connection(std::move(*addrs), std::move(options));
+}
+
+Task<Expected<Stream>> try_open_connection(std::vector<AddrInfo> addrs, ConnectOptions options) {
+    if (options.local_port_range.first > options.local_port_range.second) {
+        co_return std::make_error_code(std::errc::invalid_argument);
+    }
+    addrs = detail::interleave_families(std::move(addrs));
+
+    detail::ConnectRace race{options};
+    std::list<ScheduledTask<Task<>>> attempts;
+    size_t next = 0;
+    while (race.winner_fd() == -1) {
+        if (next < addrs.size()) {
+            race.started();
+            attempts.emplace_back(schedule_task(race.attempt(addrs[next++])));
+        } else if (race.running() == 0) {
+            break; // all attempts failed
+        }
+        // start the next attempt when this one fails, or takes longer than the delay
+        std::optional<std::chrono::milliseconds> timeout;
+        if (next < addrs.size()) { timeout = options.happy_eyeballs_delay; }
+        co_await race.wait(timeout);
     }
+    attempts.clear(); // cancels the losers, which close their sockets
+
+    if (race.winner_fd() == -1) { co_return race.error(); }
+    co_return Stream {race.release_winner()};
+}
+
+Task<Stream> open_unix_connection(std::string_view path) {
+    auto stream = co_await try_open_unix_connection(path);
+    co_return std::move(stream).value();
+}
 
-    co_return Stream {sockfd};
+Task<Expected<Stream>> try_open_unix_connection(std::string_view path) {
+    sockaddr_un addr;
+    socklen_t const addrlen = socket::unix_address(path, addr);
+    if (addrlen == 0) { co_return std::make_error_code(std::errc::filename_too_long); }
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | socket::NonBlockFlag | socket::CloExecFlag, 0);
+    if (fd == -1) { co_return std::make_error_code(static_cast<std::errc>(errno)); }
+    socket::set_blocking(fd, false);
+    socket::set_cloexec(fd);
+    // also runs when cancelled while connecting
+    finally { if (fd != -1) { ::close(fd); } };
+    std::error_code error = co_await detail::connect(fd, reinterpret_cast<const sockaddr*>(&addr), addrlen);
+    if (error) { co_return error; }
+    co_return Stream {std::exchange(fd, -1)};
 }
 
 ASYNCIO_NS_END
@@ -0,0 +1,91 @@
+//
+// Created on 2026/10/18.
+//
+#include <asyncio/relay.h>
+
+#include <asyncio/buffer_pool.h>
+#include <asyncio/finally.h>
+#include <asyncio/gather.h>
+
+#include <cerrno>
+#include <span>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+ASYNCIO_NS_BEGIN
+
+namespace {
+#if defined(__linux__)
+constexpr size_t splice_size = 64 * 1024; // the default pipe capacity
+
+[[noreturn]] void throw_errno() {
+    throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+}
+
+Task<size_t> pump(Stream& src, Stream& dst) {
+    int pipe_fds[2];
+    if (::pipe2(pipe_fds, O_NONBLOCK | O_CLOEXEC) != 0) { throw_errno(); }
+    finally {
+        ::close(pipe_fds[0]);
+        ::close(pipe_fds[1]);
+    };
+    size_t total = 0;
+    while (true) {
+        // the pipe is empty here, so EAGAIN can only mean that src has nothing to read
+        ssize_t const n = ::splice(src.get_fd(), nullptr, pipe_fds[1], nullptr, splice_size,
+                                   SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (n == 0) { break; }
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                co_await src.wait_readable();
+                continue;
+            }
+            if (errno == EINTR) { continue; }
+            throw_errno();
+        }
+        for (size_t pending = size_t(n); pending > 0; ) {
+            // splice() has no MSG_NOSIGNAL, and a dst that was reset would raise SIGPIPE
+            ssize_t const m = socket::without_sigpipe([&] {
+                return ::splice(pipe_fds[0], nullptr, dst.get_fd(), nullptr, pending,
+                                SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            });
+            if (m < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    co_await dst.wait_writable();
+                    continue;
+                }
+                if (errno == EINTR) { continue; }
+                throw_errno();
+            }
+            pending -= size_t(m);
+            total += size_t(m);
+        }
+    }
+    dst.shutdown(SHUT_WR);
+    co_return total;
+}
+#else
+Task<size_t> pump(Stream& src, Stream& dst) {
+    auto buf = get_buffer_pool().acquire(get_buffer_pool().block_size());
+    size_t total = 0;
+    while (true) {
+        auto data = co_await src.read_in_place(std::span{buf.data(), buf.capacity()});
+        if (data.empty()) { break; }
+        co_await dst.write(data);
+        total += data.size();
+    }
+    dst.shutdown(SHUT_WR);
+    co_return total;
+}
+#endif
+} // namespace
+
+Task<RelayResult> relay(Stream& a, Stream& b) {
+    auto [a_to_b, b_to_a] = co_await gather(pump(a, b), pump(b, a));
+    co_return RelayResult{ .a_to_b = a_to_b, .b_to_a = b_to_a };
+}
+
+ASYNCIO_NS_END
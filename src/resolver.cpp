@@ -0,0 +1,296 @@
+//
+// Created on 2026/10/18.
+//
+#include <asyncio/resolver.h>
+
+#include <asyncio/event_loop.h>
+#include <asyncio/finally.h>
+#include <asyncio/selector/event.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+
+ASYNCIO_NS_BEGIN
+
+struct Resolver::JobAwaiter : NonCopyable {
+    explicit JobAwaiter(std::shared_ptr<Job> job): job_(std::move(job)) {}
+    ~JobAwaiter() { std::erase(job_->waiters, waiter_); }
+
+    constexpr bool await_ready() const noexcept { return false; }
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        handle.promise().set_state(Handle::SUSPEND);
+        waiter_ = &handle.promise();
+        job_->waiters.push_back(waiter_);
+    }
+    constexpr void await_resume() const noexcept {}
+
+    std::shared_ptr<Job> job_;
+    CoroHandle *waiter_{};
+};
+
+namespace {
+// The port isn't part of the key: one lookup per name serves every port, see with_port()
+std::string cache_key(const std::string &host, const addrinfo &hints) {
+    return fmt::format("{}\n{}\n{}\n{}\n{}", host, hints.ai_family, hints.ai_socktype, hints.ai_protocol,
+                       hints.ai_flags);
+}
+
+// `addrs`, as answered for whatever port was asked for first, with `port` instead
+std::vector<AddrInfo> with_port(std::vector<AddrInfo> addrs, uint16_t port) {
+    for (auto &ai : addrs) {
+        if (ai.addr.ss_family == AF_INET) {
+            reinterpret_cast<sockaddr_in &>(ai.addr).sin_port = htons(port);
+        } else if (ai.addr.ss_family == AF_INET6) {
+            reinterpret_cast<sockaddr_in6 &>(ai.addr).sin6_port = htons(port);
+        }
+    }
+    return addrs;
+}
+} // namespace
+
+Resolver::Resolver(size_t num_threads, Lookup lookup)
+    : num_threads_(std::max<size_t>(num_threads, 1)), lookup_(std::move(lookup))
+{
+#if defined(__linux__)
+    notify_fds_[0] = notify_fds_[1] = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (notify_fds_[0] < 0) {
+        throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)), "eventfd");
+    }
+#else
+    if (::pipe(notify_fds_) != 0) {
+        throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)), "pipe");
+    }
+    for (int fd : notify_fds_) {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+}
+
+Resolver::~Resolver() {
+    dispatcher_.reset(); // unregisters the notification fd
+    {
+        std::lock_guard g(mut_);
+        stopping_ = true;
+    }
+    cond_.notify_all();
+    for (auto &t : threads_) { t.join(); }
+    if (notify_fds_[1] != notify_fds_[0]) { ::close(notify_fds_[1]); }
+    ::close(notify_fds_[0]);
+}
+
+Task<std::vector<AddrInfo>> Resolver::resolve(std::string_view host, uint16_t port, addrinfo hints) {
+    std::vector<AddrInfo> result;
+    int const rc = co_await lookup(host, port, hints, result);
+    if (rc != 0) {
+        throw std::system_error(std::make_error_code(std::errc::address_not_available),
+                                fmt::format("{}: {}", host, gai_strerror(rc)));
+    }
+    co_return result;
+}
+
+Task<Expected<std::vector<AddrInfo>>> Resolver::try_resolve(std::string_view host, uint16_t port, addrinfo hints) {
+    std::vector<AddrInfo> result;
+    int const rc = co_await lookup(host, port, hints, result);
+    if (rc != 0) {
+        co_return std::make_error_code(std::errc::address_not_available);
+    }
+    co_return result;
+}
+
+Task<int> Resolver::lookup(std::string_view host, uint16_t port, addrinfo hints, std::vector<AddrInfo> &result) {
+    std::string host_str{host};
+    std::string service = std::to_string(port);
+
+    // numeric hosts never hit the network, so there is no point in paying for a round-trip to a worker
+    addrinfo numeric_hints = hints;
+    numeric_hints.ai_flags |= AI_NUMERICHOST;
+    if (int rc = system_lookup(host_str, service, numeric_hints, result); rc != EAI_NONAME) {
+        co_return rc;
+    }
+
+    auto key = cache_key(host_str, hints);
+    if (auto iter = cache_.find(key); iter != cache_.end()) {
+        if (iter->second.expires > get_event_loop().time()) {
+            ++stats_.hits;
+            if (iter->second.rc != 0) {
+                ++stats_.negative_hits;
+                co_return iter->second.rc;
+            }
+            result = with_port(iter->second.result, port);
+            co_return 0;
+        }
+        cache_.erase(iter);
+    }
+
+    std::shared_ptr<Job> job;
+    if (auto iter = in_flight_.find(key); iter != in_flight_.end()) {
+        ++stats_.coalesced;
+        job = iter->second;
+    } else {
+        ++stats_.misses;
+        job = std::make_shared<Job>();
+        job->key = key;
+        job->host = std::move(host_str);
+        job->service = std::move(service);
+        job->hints = hints;
+        in_flight_.emplace(std::move(key), job);
+        submit(job);
+    }
+    co_await JobAwaiter{job};
+    if (job->rc == 0) { result = with_port(job->result, port); }
+    co_return job->rc;
+}
+
+void Resolver::flush_cache() {
+    cache_.clear();
+}
+
+void Resolver::flush_cache(std::string_view host) {
+    std::erase_if(cache_, [&](const auto &item) { return item.second.host == host; });
+}
+
+void Resolver::cache_answer(const Job &job) {
+    const bool negative = job.rc == EAI_NONAME;
+    const MSDuration ttl = negative ? negative_ttl_ : cache_ttl_;
+    if ((job.rc != 0 && ! negative) || ttl <= MSDuration::zero() || cache_size_ == 0) { return; }
+    const auto now = get_event_loop().time();
+    if (cache_.size() >= cache_size_) {
+        std::erase_if(cache_, [&](const auto &item) { return item.second.expires <= now; });
+        // then the oldest answers, rather than whichever the hash happens to put first
+        while (cache_.size() >= cache_size_) {
+            cache_.erase(std::ranges::min_element(cache_, {}, [](const auto &item) { return item.second.expires; }));
+        }
+    }
+    cache_.insert_or_assign(job.key, CacheEntry{job.host, now + ttl, job.rc, job.result});
+}
+
+int Resolver::system_lookup(const std::string &host, const std::string &service, const addrinfo &hints,
+                            std::vector<AddrInfo> &result) {
+    addrinfo *server_info{nullptr};
+    if (int rv = ::getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &server_info);
+            rv != 0) {
+        return rv;
+    }
+    finally { freeaddrinfo(server_info); };
+
+    for (auto p = server_info; p != nullptr; p = p->ai_next) {
+        auto &ai = result.emplace_back();
+        ai.family = p->ai_family;
+        ai.socktype = p->ai_socktype;
+        ai.protocol = p->ai_protocol;
+        ai.addrlen = std::min<socklen_t>(p->ai_addrlen, sizeof(ai.addr));
+        std::memcpy(&ai.addr, p->ai_addr, ai.addrlen);
+    }
+    return 0;
+}
+
+void Resolver::submit(std::shared_ptr<Job> job) {
+    if (threads_.empty()) {
+        // process-directed signals are for the loops that wait for them (see signal.h), not for our workers. Threads
+        // start with their creator's mask: blocking everything while creating them leaves no moment to take one.
+        sigset_t all, old_mask;
+        sigfillset(&all);
+        ::pthread_sigmask(SIG_BLOCK, &all, &old_mask);
+        finally { ::pthread_sigmask(SIG_SETMASK, &old_mask, nullptr); };
+        for (size_t i = 0; i < num_threads_; ++i) {
+            threads_.emplace_back([this] { worker(); });
+        }
+    }
+    {
+        std::lock_guard g(mut_);
+        queue_.push_back(std::move(job));
+    }
+    cond_.notify_one();
+    ++pending_;
+    if (! dispatcher_ || dispatcher_->done()) {
+        dispatcher_.emplace(dispatch_completions());
+    }
+}
+
+void Resolver::worker() {
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock lock(mut_);
+            cond_.wait(lock, [this] { return stopping_ || ! queue_.empty(); });
+            if (stopping_) { return; }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        try {
+            job->rc = lookup_(job->host, job->service, job->hints, job->result);
+        } catch (...) {
+            job->rc = EAI_FAIL;
+        }
+        {
+            std::lock_guard g(mut_);
+            done_.push_back(std::move(job));
+        }
+        notify_loop();
+    }
+}
+
+Task<> Resolver::dispatch_completions() {
+    Event ev { .fd = notify_fds_[0], .flags = Event::Flags::EVENT_READ };
+    auto& loop = get_event_loop();
+    auto ev_awaiter = loop.wait_event(ev);
+    // only stay registered while lookups are in flight, so that the loop can finish when there is nothing left to do
+    while (pending_ > 0) {
+        co_await ev_awaiter;
+        drain_notifications();
+        std::vector<std::shared_ptr<Job>> done;
+        {
+            std::lock_guard g(mut_);
+            done.swap(done_);
+        }
+        for (auto &job : done) {
+            --pending_;
+            in_flight_.erase(job->key);
+            cache_answer(*job);
+            for (auto waiter : job->waiters) { loop.call_soon(*waiter); }
+        }
+    }
+}
+
+void Resolver::notify_loop() {
+#if defined(__linux__)
+    const uint64_t one = 1;
+#else
+    const char one = 1;
+#endif
+    while (::write(notify_fds_[1], &one, sizeof(one)) < 0 && errno == EINTR) {}
+}
+
+void Resolver::drain_notifications() {
+    char buf[64];
+    while (true) {
+        ssize_t sz = ::read(notify_fds_[0], buf, sizeof(buf));
+        if (sz > 0 && size_t(sz) == sizeof(buf)) { continue; }
+        if (sz < 0 && errno == EINTR) { continue; }
+        break;
+    }
+}
+
+Resolver &get_resolver() {
+    get_event_loop(); // make sure the loop outlives the resolver, which may still be registered with its selector
+    thread_local std::unique_ptr<Resolver> resolver;
+    if (!resolver) [[unlikely]] resolver = std::make_unique<Resolver>();
+    return *resolver;
+}
+
+ASYNCIO_NS_END
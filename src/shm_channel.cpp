@@ -0,0 +1,348 @@
+//
+// Created on 2026/10/18.
+//
+#include <asyncio/shm_channel.h>
+#include <asyncio/event_loop.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+
+ASYNCIO_NS_BEGIN
+
+namespace detail {
+// The shared state of one direction, at the start of its page, followed by the ring's data. `head` and `tail` count
+// the bytes ever written and read, so the ring is empty when they are equal and full when they are `capacity` apart.
+// Each lives on its own cache line, as producer and consumer write them all the time.
+struct ShmRing {
+    static constexpr size_t header_size = 4096;
+
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    // Set by a side about to wait on its doorbell; the other side clears it when ringing the doorbell.
+    alignas(64) std::atomic<uint32_t> consumer_sleeping{0};
+    std::atomic<uint32_t> producer_sleeping{0};
+    std::atomic<uint32_t> producer_closed{0};
+    std::atomic<uint32_t> consumer_closed{0};
+
+    std::byte* data() { return reinterpret_cast<std::byte*>(this) + header_size; }
+};
+static_assert(sizeof(ShmRing) <= ShmRing::header_size);
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the rings are shared between processes");
+} // namespace detail
+
+using detail::ShmRing;
+
+namespace {
+[[noreturn]] void throw_errno() {
+    throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+}
+
+void close_fd(int& fd) {
+    if (fd != -1) { ::close(fd); }
+    fd = -1;
+}
+
+// Resets a doorbell after waking up on it.
+void drain(int doorbell) {
+    uint64_t count;
+    [[maybe_unused]] auto rc = ::read(doorbell, &count, sizeof(count));
+}
+
+size_t capacity_of(size_t mapping_size) { return mapping_size / 2 - ShmRing::header_size; }
+} // namespace
+
+ShmChannel ShmChannel::create(size_t capacity)
+{
+#if defined(__linux__)
+    size_t const page = size_t(::sysconf(_SC_PAGESIZE));
+    capacity = (std::max<size_t>(capacity, 1) + page - 1) / page * page;
+    // the memfd, the doorbells, then our end and the other end of the socket pair
+    int fds[1 + fd_count + 2];
+    std::ranges::fill(fds, -1);
+    auto fail = [&fds] {
+        int const error = errno;
+        for (int fd : fds) { if (fd != -1) { ::close(fd); } }
+        errno = error;
+        throw_errno();
+    };
+    fds[0] = ::memfd_create("asyncio-shm-channel", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fds[0] == -1) { fail(); }
+    for (int i = 0; i < fd_count; ++i) {
+        fds[1 + i] = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fds[1 + i] == -1) { fail(); }
+    }
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, &fds[1 + fd_count]) != 0) { fail(); }
+    // sealed, so that neither side can shrink the mapping under the other, which would fault on access
+    if (::ftruncate(fds[0], off_t(2 * (ShmRing::header_size + capacity))) != 0
+        || ::fcntl(fds[0], F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        fail();
+    }
+    int const doorbells[fd_count] = {fds[1], fds[2], fds[3], fds[4]};
+    ShmChannel channel{fds[0], doorbells, fds[1 + fd_count], true};
+    channel.peer_handoff_ = fds[2 + fd_count];
+    new (channel.tx_) ShmRing{};
+    new (channel.rx_) ShmRing{};
+    return channel;
+#else
+    throw std::system_error(std::make_error_code(std::errc::function_not_supported));
+#endif
+}
+
+ShmChannel ShmChannel::attach(std::span<const int> fds)
+{
+    if (fds.size() != 1 + fd_count + 1) {
+        throw std::system_error(std::make_error_code(std::errc::invalid_argument));
+    }
+    int const doorbells[fd_count] = {fds[1], fds[2], fds[3], fds[4]};
+    return ShmChannel{fds[0], doorbells, fds[1 + fd_count], false};
+}
+
+ShmChannel::ShmChannel(int memfd, const int (&doorbells)[fd_count], int peer, bool creator)
+    : memfd_(memfd),
+      data_in_(doorbells[creator ? data_doorbell_1 : data_doorbell_0]),
+      space_out_(doorbells[creator ? space_doorbell_0 : space_doorbell_1]),
+      data_out_(doorbells[creator ? data_doorbell_0 : data_doorbell_1]),
+      space_in_(doorbells[creator ? space_doorbell_1 : space_doorbell_0]),
+      peer_(peer),
+      creator_(creator)
+{
+    struct stat st{};
+    if (::fstat(memfd_, &st) != 0 || size_t(st.st_size) <= 2 * ShmRing::header_size) {
+        int const error = size_t(st.st_size) <= 2 * ShmRing::header_size ? EINVAL : errno;
+        close();
+        throw std::system_error(std::make_error_code(static_cast<std::errc>(error)));
+    }
+#if defined(F_GET_SEALS)
+    // the creator's seals are what keeps the size we map now from changing
+    int const seals = ::fcntl(memfd_, F_GET_SEALS);
+    if (seals == -1 || (seals & F_SEAL_SHRINK) == 0) {
+        close();
+        throw std::system_error(std::make_error_code(std::errc::invalid_argument));
+    }
+#endif
+    void* mapping = ::mmap(nullptr, size_t(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, memfd_, 0);
+    if (mapping == MAP_FAILED) {
+        int const error = errno;
+        close();
+        throw std::system_error(std::make_error_code(static_cast<std::errc>(error)));
+    }
+    mapping_ = static_cast<std::byte*>(mapping);
+    mapping_size_ = size_t(st.st_size);
+    auto ring0 = reinterpret_cast<ShmRing*>(mapping_);
+    auto ring1 = reinterpret_cast<ShmRing*>(mapping_ + ShmRing::header_size + capacity_of(mapping_size_));
+    tx_ = creator ? ring0 : ring1;
+    rx_ = creator ? ring1 : ring0;
+}
+
+ShmChannel::ShmChannel(ShmChannel&& other)
+    : memfd_(std::exchange(other.memfd_, -1)),
+      mapping_(std::exchange(other.mapping_, nullptr)),
+      mapping_size_(std::exchange(other.mapping_size_, 0)),
+      tx_(std::exchange(other.tx_, nullptr)),
+      rx_(std::exchange(other.rx_, nullptr)),
+      data_in_(std::move(other.data_in_)),
+      space_out_(std::move(other.space_out_)),
+      data_out_(std::exchange(other.data_out_, -1)),
+      space_in_(std::exchange(other.space_in_, -1)),
+      peer_(std::exchange(other.peer_, -1)),
+      peer_handoff_(std::exchange(other.peer_handoff_, -1)),
+      creator_(other.creator_),
+      watching_peer_(std::exchange(other.watching_peer_, false)),
+      peer_gone_(other.peer_gone_),
+      stats_(other.stats_)
+{
+    // the watcher calls back the channel at its new address
+    if (watching_peer_) { get_event_loop().add_reader(peer_, [this] { on_peer_gone(); }); }
+}
+
+ShmChannel::~ShmChannel() { close(); }
+
+void ShmChannel::close()
+{
+    if (tx_) {
+        tx_->producer_closed.store(1);
+        if (tx_->consumer_sleeping.exchange(0)) { ring_doorbell(data_out_); }
+    }
+    if (rx_) {
+        rx_->consumer_closed.store(1);
+        if (rx_->producer_sleeping.exchange(0)) { ring_doorbell(space_in_); }
+    }
+    tx_ = rx_ = nullptr;
+    if (mapping_) { ::munmap(mapping_, mapping_size_); }
+    mapping_ = nullptr;
+    data_in_.close();
+    space_out_.close();
+    close_fd(data_out_);
+    close_fd(space_in_);
+    close_fd(memfd_);
+    if (watching_peer_) { get_event_loop().remove_reader(peer_); }
+    watching_peer_ = false;
+    close_fd(peer_);
+    close_fd(peer_handoff_);
+}
+
+std::vector<int> ShmChannel::peer_fds()
+{
+    if (memfd_ == -1 || peer_handoff_ == -1) {
+        throw std::system_error(std::make_error_code(std::errc::bad_file_descriptor));
+    }
+    int const ours[1 + fd_count] = {memfd_, data_out_, space_out_.get_fd(), data_in_.get_fd(), space_in_};
+    std::vector<int> fds;
+    for (int fd : ours) {
+        int const dup = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        if (dup == -1) {
+            int const error = errno;
+            for (int done : fds) { ::close(done); }
+            errno = error;
+            throw_errno();
+        }
+        fds.push_back(dup);
+    }
+    // not a copy: the other side is gone when its end is, so we mustn't keep one
+    fds.push_back(std::exchange(peer_handoff_, -1));
+    return fds;
+}
+
+size_t ShmChannel::capacity() const { return mapping_ ? capacity_of(mapping_size_) : 0; }
+
+void ShmChannel::ring_doorbell(int doorbell)
+{
+    uint64_t const one = 1;
+    [[maybe_unused]] auto rc = ::write(doorbell, &one, sizeof(one));
+    ++stats_.doorbells;
+}
+
+void ShmChannel::watch_peer()
+{
+    if (watching_peer_ || peer_gone_ || peer_ == -1) { return; }
+    get_event_loop().add_reader(peer_, [this] { on_peer_gone(); });
+    watching_peer_ = true;
+}
+
+void ShmChannel::on_peer_gone()
+{
+    // Nothing is ever sent on the socket pair: it is readable once the other end is closed, by close() or by the
+    // peer's process going away.
+    get_event_loop().remove_reader(peer_);
+    watching_peer_ = false;
+    peer_gone_ = true;
+    // wake ourselves, for a reader or writer waiting on a doorbell that won't be rung anymore
+    uint64_t const one = 1;
+    [[maybe_unused]] auto rc = ::write(data_in_.get_fd(), &one, sizeof(one));
+    rc = ::write(space_out_.get_fd(), &one, sizeof(one));
+}
+
+Task<size_t> ShmChannel::read_bytes(std::span<std::byte> buffer, bool fill_buffer)
+{
+    size_t nread = 0;
+    while (nread < buffer.size()) {
+        if (! rx_) [[unlikely]] { throw std::system_error(std::make_error_code(std::errc::bad_file_descriptor)); }
+        ShmRing& ring = *rx_;
+        size_t const capacity = capacity_of(mapping_size_);
+        uint64_t const tail = ring.tail.load(std::memory_order_relaxed);
+        uint64_t const head = ring.head.load(std::memory_order_acquire);
+        if (head - tail > capacity) [[unlikely]] {
+            throw std::system_error(std::make_error_code(std::errc::protocol_error));
+        }
+        if (head != tail) {
+            size_t const n = std::min<size_t>(head - tail, buffer.size() - nread);
+            size_t const pos = size_t(tail % capacity);
+            size_t const first = std::min(n, capacity - pos);
+            std::memcpy(buffer.data() + nread, ring.data() + pos, first);
+            std::memcpy(buffer.data() + nread + first, ring.data(), n - first);
+            ring.tail.store(tail + n, std::memory_order_release);
+            nread += n;
+            // pairs with the producer's check of `tail` after it announced that it sleeps
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (ring.producer_sleeping.load(std::memory_order_relaxed) && ring.producer_sleeping.exchange(0)) {
+                ring_doorbell(space_in_);
+            }
+            if (! fill_buffer) { break; }
+            continue;
+        }
+        if (ring.producer_closed.load(std::memory_order_acquire)) {
+            // closing comes after the producer's last write, which is visible by now
+            if (ring.head.load(std::memory_order_acquire) != tail) { continue; }
+            break; // EOF
+        }
+        if (peer_gone_) [[unlikely]] { break; } // without closing its end: EOF all the same, once the ring is drained
+        // Nothing to read. Ask for the doorbell, then look once more, for data that came in before the producer could
+        // have seen that we asked.
+        watch_peer();
+        ring.consumer_sleeping.store(1);
+        if (ring.head.load() != tail || ring.producer_closed.load()) {
+            ring.consumer_sleeping.store(0, std::memory_order_relaxed);
+            continue;
+        }
+        ++stats_.waits;
+        co_await data_in_.wait_readable();
+        drain(data_in_.get_fd());
+        if (rx_) { rx_->consumer_sleeping.store(0, std::memory_order_relaxed); }
+    }
+    co_return nread;
+}
+
+Task<> ShmChannel::write_bytes(std::span<const std::byte> bytes)
+{
+    while (! bytes.empty()) {
+        if (! tx_) [[unlikely]] { throw std::system_error(std::make_error_code(std::errc::bad_file_descriptor)); }
+        ShmRing& ring = *tx_;
+        if (ring.consumer_closed.load(std::memory_order_acquire)) [[unlikely]] {
+            throw std::system_error(std::make_error_code(std::errc::broken_pipe));
+        }
+        if (peer_gone_) [[unlikely]] {
+            throw std::system_error(std::make_error_code(std::errc::connection_reset));
+        }
+        size_t const capacity = capacity_of(mapping_size_);
+        uint64_t const head = ring.head.load(std::memory_order_relaxed);
+        uint64_t const tail = ring.tail.load(std::memory_order_acquire);
+        if (head - tail > capacity) [[unlikely]] {
+            throw std::system_error(std::make_error_code(std::errc::protocol_error));
+        }
+        size_t const room = capacity - size_t(head - tail);
+        if (room > 0) {
+            size_t const n = std::min(room, bytes.size());
+            size_t const pos = size_t(head % capacity);
+            size_t const first = std::min(n, capacity - pos);
+            std::memcpy(ring.data() + pos, bytes.data(), first);
+            std::memcpy(ring.data(), bytes.data() + first, n - first);
+            ring.head.store(head + n, std::memory_order_release);
+            bytes = bytes.subspan(n);
+            // pairs with the consumer's check of `head` after it announced that it sleeps
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (ring.consumer_sleeping.load(std::memory_order_relaxed) && ring.consumer_sleeping.exchange(0)) {
+                ring_doorbell(data_out_);
+            }
+            continue;
+        }
+        // The ring is full: wait for the consumer to make room, the same way it waits for data.
+        watch_peer();
+        ring.producer_sleeping.store(1);
+        if (ring.tail.load() != tail || ring.consumer_closed.load()) {
+            ring.producer_sleeping.store(0, std::memory_order_relaxed);
+            continue;
+        }
+        ++stats_.waits;
+        co_await space_out_.wait_readable();
+        drain(space_out_.get_fd());
+        if (tx_) { tx_->producer_sleeping.store(0, std::memory_order_relaxed); }
+    }
+}
+
+ASYNCIO_NS_END
@@ -0,0 +1,199 @@
+//
+// Created on 2026/10/18.
+//
+#include <asyncio/signal.h>
+#include <asyncio/event_loop.h>
+#include <asyncio/handle.h>
+#include <asyncio/noncopyable.h>
+
+#include <cerrno>
+#include <list>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/signalfd.h>
+#endif
+
+ASYNCIO_NS_BEGIN
+
+namespace {
+[[noreturn]] void throw_error(std::errc error) {
+    throw std::system_error(std::make_error_code(error));
+}
+
+#if defined(__linux__)
+// The signals of one thread's loop, and its signalfd. The fd only reads the signals someone waits for right now,
+// and is only registered with the loop while there are any: the others stay pending.
+class Signals : NonCopyable {
+public:
+    struct WaitAwaiter;
+
+    ~Signals() {
+        if (reading_) { get_event_loop().remove_reader(fd_); }
+        if (fd_ != -1) { ::close(fd_); }
+        std::lock_guard lock(owners_mutex);
+        std::erase_if(owners, [this](auto& owner) { return owner.second == this; });
+    }
+
+    // Makes `signo` ours, blocked and read from our fd when asked for.
+    void claim(int signo) {
+        if (signo <= 0 || signo >= NSIG || signo == SIGKILL || signo == SIGSTOP) {
+            throw_error(std::errc::invalid_argument);
+        }
+        if (owned_.contains(signo)) { return; }
+        if (fd_ == -1) {
+            sigset_t none;
+            sigemptyset(&none);
+            fd_ = ::signalfd(-1, &none, SFD_NONBLOCK | SFD_CLOEXEC);
+            if (fd_ == -1) { throw_error(static_cast<std::errc>(errno)); }
+        }
+        {
+            std::lock_guard lock(owners_mutex);
+            auto [iter, inserted] = owners.try_emplace(signo, this);
+            if (! inserted && iter->second != this) { throw_error(std::errc::device_or_resource_busy); }
+        }
+        sigset_t set;
+        sigemptyset(&set);
+        sigaddset(&set, signo);
+        ::pthread_sigmask(SIG_BLOCK, &set, nullptr);
+        owned_[signo];
+    }
+
+    void add_handler(int signo, std::function<void()> callback) {
+        claim(signo);
+        owned_[signo].handler = std::move(callback);
+        update();
+    }
+
+    bool remove_handler(int signo) {
+        auto iter = owned_.find(signo);
+        if (iter == owned_.end() || ! iter->second.handler) { return false; }
+        iter->second.handler = nullptr;
+        update();
+        return true;
+    }
+
+private:
+    struct Interest {
+        std::function<void()> handler;
+        std::list<CoroHandle*> waiters;
+        bool active() const { return handler || ! waiters.empty(); }
+    };
+
+    // Points our fd at the signals with handlers or waiters, and reads it only while there are any.
+    void update() {
+        sigset_t active;
+        sigemptyset(&active);
+        bool any = false;
+        for (auto& [signo, interest] : owned_) {
+            if (interest.active()) {
+                sigaddset(&active, signo);
+                any = true;
+            }
+        }
+        ::signalfd(fd_, &active, 0);
+        auto& loop = get_event_loop();
+        if (any && ! reading_) {
+            loop.add_reader(fd_, [this] { on_readable(); });
+        } else if (! any && reading_) {
+            loop.remove_reader(fd_);
+        }
+        reading_ = any;
+    }
+
+    void on_readable() {
+        signalfd_siginfo infos[16];
+        ssize_t n;
+        while ((n = ::read(fd_, infos, sizeof(infos))) > 0) {
+            for (size_t i = 0; i < size_t(n) / sizeof(signalfd_siginfo); ++i) {
+                dispatch(int(infos[i].ssi_signo));
+            }
+        }
+        update();
+    }
+
+    void dispatch(int signo) {
+        auto iter = owned_.find(signo);
+        if (iter == owned_.end()) { return; }
+        auto waiters = std::exchange(iter->second.waiters, {});
+        for (auto waiter : waiters) { get_event_loop().call_soon(*waiter); }
+        // a copy: the handler may replace or remove itself
+        if (auto handler = iter->second.handler) { handler(); }
+    }
+
+    static inline std::mutex owners_mutex;
+    static inline std::unordered_map<int, Signals*> owners; // the loop each signal is delivered to
+
+    int fd_ { -1 };
+    bool reading_ { false };
+    std::unordered_map<int, Interest> owned_;
+};
+
+struct Signals::WaitAwaiter : NonCopyable {
+    WaitAwaiter(Signals& signals, int signo): signals_(signals), signo_(signo) {}
+    ~WaitAwaiter() {
+        if (handle_) {
+            // resumed, or cancelled while waiting
+            std::erase(signals_.owned_[signo_].waiters, handle_);
+            signals_.update();
+        }
+    }
+
+    constexpr bool await_ready() const noexcept { return false; }
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> continuation) {
+        continuation.promise().set_state(Handle::SUSPEND);
+        handle_ = &continuation.promise();
+        signals_.owned_[signo_].waiters.push_back(handle_);
+        signals_.update();
+    }
+    void await_resume() noexcept { }
+
+    Signals& signals_;
+    int signo_;
+    CoroHandle* handle_{};
+};
+
+Signals& signals() {
+    get_event_loop(); // constructed first, so that it is still there when our thread_local goes away
+    thread_local Signals signals;
+    return signals;
+}
+#endif
+} // namespace
+
+Task<> wait_signal(int signo) {
+#if defined(__linux__)
+    auto& s = signals();
+    s.claim(signo);
+    co_await Signals::WaitAwaiter{s, signo};
+#else
+    throw_error(std::errc::function_not_supported);
+    co_return;
+#endif
+}
+
+void add_signal_handler(int signo, std::function<void()> callback) {
+#if defined(__linux__)
+    signals().add_handler(signo, std::move(callback));
+#else
+    throw_error(std::errc::function_not_supported);
+#endif
+}
+
+bool remove_signal_handler(int signo) {
+#if defined(__linux__)
+    return signals().remove_handler(signo);
+#else
+    return false;
+#endif
+}
+
+ASYNCIO_NS_END
@@ -3,6 +3,13 @@
 //
 #include <asyncio/stream.h>
 
+#include <asyncio/buffer_pool.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstring>
 #include <utility>
 
 #include <fcntl.h>
@@ -11,10 +18,24 @@
 #include <sys/ioctl.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/sendfile.h>
+#endif
+
 #ifndef SOCK_NONBLOCK /* If Protocol not supported */
 #define SOCK_NONBLOCK 0
 #endif
 
+#ifndef SOCK_CLOEXEC
+#define SOCK_CLOEXEC 0
+#endif
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
 ASYNCIO_NS_BEGIN
 
 namespace socket {
@@ -48,53 +69,579 @@ namespace socket {
     }
 
     const int NonBlockFlag = SOCK_NONBLOCK;
+    const int CloExecFlag = SOCK_CLOEXEC;
+
+    bool set_cloexec(int fd) {
+        if (fd < 0)
+            return false;
+        if constexpr (SOCK_CLOEXEC != 0) {
+            return true;
+        } else {
+            return ::fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+        }
+    }
+
+    int accept(int fd, sockaddr* addr, socklen_t* addrlen) {
+#if defined(__linux__)
+        return ::accept4(fd, addr, addrlen, SOCK_CLOEXEC);
+#else
+        int const client = ::accept(fd, addr, addrlen);
+        set_cloexec(client);
+        return client;
+#endif
+    }
+
+    socklen_t unix_address(std::string_view path, sockaddr_un& addr) {
+        addr = sockaddr_un{};
+        addr.sun_family = AF_UNIX;
+        // a file path needs its terminating '\0' to fit, an abstract name is taken as is
+        bool const abstract = ! path.empty() && path.front() == '\0';
+        if (path.empty() || path.size() + (abstract ? 0 : 1) > sizeof(addr.sun_path)) { return 0; }
+        std::memcpy(addr.sun_path, path.data(), path.size());
+        return socklen_t(offsetof(sockaddr_un, sun_path) + path.size() + (abstract ? 0 : 1));
+    }
 } // namespace socket
 
 
-Stream::Stream(int fd)
-    : read_fd_(fd), write_fd_(fd)
+// The stream's timeouts, and the one timer enforcing them. Waits only note when they started; the timer checks the
+// actual deadline when it fires and re-arms itself if that moved on in the meantime.
+struct Stream::Deadlines : Handle {
+    using MSDuration = std::chrono::milliseconds;
+    static constexpr MSDuration never = MSDuration::max();
+
+    explicit Deadlines(Stream& stream) : stream(&stream), last_activity(get_event_loop().time()) { }
+    ~Deadlines() {
+        if (armed_at != never) { get_event_loop().cancel_handle(*this); }
+    }
+
+    // The earliest deadline of the pending waits, or `never`.
+    MSDuration deadline() const {
+        MSDuration result = never;
+        auto wait_deadline = [&](MSDuration since, MSDuration timeout) {
+            if (since == never) { return; }
+            if (timeout > MSDuration::zero()) { result = std::min(result, since + timeout); }
+            if (idle_timeout > MSDuration::zero()) { result = std::min(result, last_activity + idle_timeout); }
+        };
+        wait_deadline(read_since, read_timeout);
+        wait_deadline(write_since, write_timeout);
+        return result;
+    }
+
+    bool expired(MSDuration since, MSDuration timeout, MSDuration now) const {
+        if (since == never) { return false; }
+        return (timeout > MSDuration::zero() && since + timeout <= now)
+            || (idle_timeout > MSDuration::zero() && last_activity + idle_timeout <= now);
+    }
+
+    // Makes sure the timer fires no later than the current deadline.
+    void arm() {
+        MSDuration const when = deadline();
+        if (when >= armed_at) { return; } // it will fire first, and find the deadline hasn't come yet
+        EventLoop& loop = get_event_loop();
+        if (armed_at != never) {
+            loop.cancel_handle(*this);
+            renew_handle_id();
+        }
+        armed_at = when;
+        loop.call_later(std::max(when - loop.time(), MSDuration::zero()), *this);
+    }
+
+    void run() override final {
+        armed_at = never;
+        MSDuration const now = get_event_loop().time();
+        if (expired(read_since, read_timeout, now)) { stream->expire(true); }
+        if (expired(write_since, write_timeout, now)) { stream->expire(false); }
+        arm();
+    }
+
+    Stream* stream;
+    MSDuration read_timeout{}, write_timeout{}, idle_timeout{};
+    MSDuration last_activity;
+    MSDuration read_since{never}, write_since{never}; // when the pending read / write started waiting
+    MSDuration armed_at{never};
+    bool read_timed_out{false}, write_timed_out{false};
+};
+
+void Stream::begin_wait(bool reading) noexcept
+{
+    (reading ? deadlines_->read_since : deadlines_->write_since) = get_event_loop().time();
+    deadlines_->arm();
+}
+
+std::error_code Stream::end_wait(bool reading) noexcept
+{
+    auto& d = *deadlines_;
+    (reading ? d.read_since : d.write_since) = Deadlines::never;
+    if (std::exchange(reading ? d.read_timed_out : d.write_timed_out, false)) [[unlikely]] {
+        return std::make_error_code(std::errc::timed_out);
+    }
+    d.last_activity = get_event_loop().time();
+    return {};
+}
+
+// Wakes up the coroutine waiting to read (or write), which then finds that it timed out.
+void Stream::expire(bool reading)
+{
+    (reading ? deadlines_->read_since : deadlines_->write_since) = Deadlines::never;
+    (reading ? deadlines_->read_timed_out : deadlines_->write_timed_out) = true;
+    Event& event = reading ? read_ev_ : write_ev_;
+    Handle* waiter = event.handle_info.handle;
+    // unregister, so that the fd becoming ready can't resume it a second time; the next wait registers again
+    remove_event(reading);
+    event.handle_info = {};
+    get_event_loop().call_soon(*waiter);
+}
+
+void Stream::set_read_timeout(std::chrono::milliseconds timeout)
+{
+    if (! deadlines_) { deadlines_ = std::make_unique<Deadlines>(*this); }
+    deadlines_->read_timeout = timeout;
+    deadlines_->arm();
+}
+
+void Stream::set_write_timeout(std::chrono::milliseconds timeout)
 {
-    if (read_fd_ >= 0) {
-        socklen_t addrlen = sizeof(sock_info_);
-        getsockname(read_fd_, reinterpret_cast<sockaddr*>(reinterpret_cast<std::byte*>(&sock_info_)), &addrlen);
-        addrlen = sizeof(peer_sock_info_);
-        getpeername(read_fd_, reinterpret_cast<sockaddr*>(reinterpret_cast<std::byte*>(&peer_sock_info_)), &addrlen);
+    if (! deadlines_) { deadlines_ = std::make_unique<Deadlines>(*this); }
+    deadlines_->write_timeout = timeout;
+    deadlines_->arm();
+}
+
+void Stream::set_idle_timeout(std::chrono::milliseconds timeout)
+{
+    if (! deadlines_) { deadlines_ = std::make_unique<Deadlines>(*this); }
+    deadlines_->idle_timeout = timeout;
+    deadlines_->arm();
+}
+
+#if defined(__linux__) && defined(SO_ZEROCOPY)
+struct Stream::ZeroCopyState {
+    explicit ZeroCopyState(int fd) : errqueue { get_event_loop().wait_event({ .fd = fd, .flags = Event::Flags::EVENT_ERROR }) } {
+        // from now on EPOLLERR goes to us rather than to the stream's readers & writers, see EpollSelector::select();
+        // if the fd can't be registered, the first wait for completions throws why
+        errqueue.arm();
     }
+
+    // Reads all completion notifications off the socket error queue, returns whether there were any.
+    bool reap(int fd) {
+        bool reaped = false;
+        while (true) {
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(sock_extended_err))];
+            msghdr msg{ .msg_control = control, .msg_controllen = sizeof(control) };
+            if (::recvmsg(fd, &msg, MSG_ERRQUEUE) < 0) {
+                if (errno == EINTR) { continue; }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) { return reaped; }
+                throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+            }
+            for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg, cm)) {
+                if (! ((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR)
+                       || (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR))) { continue; }
+                sock_extended_err err;
+                std::memcpy(&err, CMSG_DATA(cm), sizeof(err));
+                if (err.ee_origin != SO_EE_ORIGIN_ZEROCOPY) { continue; }
+                // sends [ee_info, ee_data] are done; the 32 bit counter wraps, which unsigned arithmetic takes care of
+                completed += err.ee_data - err.ee_info + 1;
+                if (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) { ++stats.copied; }
+                reaped = true;
+            }
+        }
+    }
+
+    // Waits until the kernel released every page handed to it so far.
+    Task<> wait_completed(int fd) {
+        while (completed != sent) {
+            if (reap(fd)) { continue; }
+            int error = 0;
+            socklen_t len = sizeof(error);
+            if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) == 0 && error != 0) [[unlikely]] {
+                throw std::system_error(std::make_error_code(static_cast<std::errc>(error)));
+            }
+            co_await errqueue;
+        }
+    }
+
+    EventLoop::WaitEventAwaiter errqueue;
+    uint32_t sent{};      // send() calls so far, as numbered by the kernel
+    uint32_t completed{}; // of those, the ones the kernel reported done
+    ZeroCopyStats stats;
+};
+#else
+struct Stream::ZeroCopyState { };
+#endif
+
+struct Stream::Addresses {
+    sockaddr_storage local{}, peer{};
+};
+
+Stream::Stream(int fd)
+{
+    read_ev_.fd = write_ev_.fd = fd;
 }
 
-Stream::Stream(int fd, const sockaddr_storage& sockinfo): read_fd_(fd), write_fd_(fd), sock_info_(sockinfo) { }
+Stream::Stream(int fd, const sockaddr_storage&): Stream(fd) { }
 
 Stream::Stream(Stream&& other)
-    : read_fd_{std::exchange(other.read_fd_, -1) },
-      write_fd_{std::exchange(other.write_fd_, -1) },
-      is_shut_down{std::exchange(other.is_shut_down, false)},
-      read_ev_{ std::exchange(other.read_ev_, {}) },
-      write_ev_{ std::exchange(other.write_ev_, {}) },
-      read_awaiter_{ std::move(other.read_awaiter_) },
-      write_awaiter_{ std::move(other.write_awaiter_) },
-      sock_info_{ other.sock_info_ },
-      peer_sock_info_{ other.peer_sock_info_ }
-{}
+    : read_ev_{ .fd = other.read_ev_.fd, .flags = Event::Flags::EVENT_READ },
+      write_ev_{ .fd = other.write_ev_.fd, .flags = Event::Flags::EVENT_WRITE },
+      is_shut_down{ other.is_shut_down },
+      not_socket_{ other.not_socket_ },
+      deadlines_{ std::move(other.deadlines_) },
+      zerocopy_{ std::move(other.zerocopy_) }, // heap allocated, so its registration stays valid
+      addresses_{ std::move(other.addresses_) }
+{
+    if (deadlines_) { deadlines_->stream = this; }
+    // The selector holds on to the address of the events, so those can't be moved once registered. Instead the events
+    // of `other` are unregistered, and ours register afresh on first use.
+    other.remove_event(true);
+    other.remove_event(false);
+    other.read_ev_.fd = other.write_ev_.fd = -1;
+    other.is_shut_down = false;
+}
 
 Stream::~Stream() { close(); }
 
+void Stream::register_event(bool reading) noexcept
+{
+    if (reading ? read_registered_ : write_registered_) { return; }
+    get_event_loop().register_event(reading ? read_ev_ : write_ev_);
+    (reading ? read_registered_ : write_registered_) = true;
+}
+
+void Stream::remove_event(bool reading) noexcept
+{
+    if (! (reading ? read_registered_ : write_registered_)) { return; }
+    get_event_loop().remove_event(reading ? read_ev_ : write_ev_);
+    (reading ? read_registered_ : write_registered_) = false;
+}
+
 void Stream::close()
 {
-    read_awaiter_.destroy();
-    write_awaiter_.destroy();
-    if (read_fd_ >= 0) { ::close(read_fd_); }
-    if (write_fd_ >= 0 && write_fd_ != read_fd_) { ::close(write_fd_); }
-    read_fd_ = write_fd_ = -1;
+    deadlines_.reset();
+    zerocopy_.reset();
+    remove_event(true);
+    remove_event(false);
+    if (get_fd() >= 0) { ::close(get_fd()); }
+    read_ev_.fd = write_ev_.fd = -1;
 }
 
-void Stream::shutdown()
+void Stream::shutdown(int how)
 {
-    if (!is_shut_down) {
-        is_shut_down = true;
-        read_awaiter_.destroy();
-        write_awaiter_.destroy();
-        if (read_fd_ > -1) ::shutdown(read_fd_, SHUT_RDWR);
-        if (read_fd_ != write_fd_ && write_fd_ > -1) ::shutdown(write_fd_, SHUT_RDWR);
+    if (is_shut_down) { return; }
+    if (how == SHUT_RDWR) { is_shut_down = true; }
+    if (how != SHUT_WR) { remove_event(true); }
+    if (how != SHUT_RD) { remove_event(false); }
+    if (get_fd() > -1) ::shutdown(get_fd(), how);
+}
+
+const sockaddr_storage& Stream::get_sock_info(bool peer) const
+{
+    if (! addresses_) {
+        addresses_ = std::make_unique<Addresses>();
+        socklen_t addrlen = sizeof(addresses_->local);
+        getsockname(get_fd(), reinterpret_cast<sockaddr*>(reinterpret_cast<std::byte*>(&addresses_->local)), &addrlen);
+        addrlen = sizeof(addresses_->peer);
+        getpeername(get_fd(), reinterpret_cast<sockaddr*>(reinterpret_cast<std::byte*>(&addresses_->peer)), &addrlen);
+    }
+    return peer ? addresses_->peer : addresses_->local;
+}
+
+Task<BufferLease> Stream::read_pooled(size_t size)
+{
+    auto result = co_await try_read_pooled(size);
+    co_return std::move(result).value();
+}
+
+Task<Expected<BufferLease>> Stream::try_read_pooled(size_t size)
+{
+    std::error_code const timeout = co_await readable();
+    if (timeout) [[unlikely]] { co_return timeout; }
+    BufferPool& pool = get_buffer_pool();
+    BufferLease buf = pool.acquire(size ? size : pool.block_size());
+    ssize_t const sz = ::read(get_fd(), buf.data(), buf.size());
+    if (sz < 0) [[unlikely]] {
+        co_return std::make_error_code(static_cast<std::errc>(errno));
+    }
+    buf.resize(size_t(sz));
+    co_return std::move(buf);
+}
+
+ssize_t Stream::write_some(const void* data, size_t size)
+{
+#if defined(MSG_NOSIGNAL)
+    if (! not_socket_) [[likely]] {
+        ssize_t const sz = ::send(get_fd(), data, size, MSG_NOSIGNAL);
+        if (sz >= 0 || errno != ENOTSOCK) { return sz; }
+        not_socket_ = true; // one failed send() per stream, not one per write
+    }
+#endif
+    return socket::without_sigpipe([&] { return ::write(get_fd(), data, size); });
+}
+
+ssize_t Stream::writev_some(std::span<const iovec> iov)
+{
+#if defined(MSG_NOSIGNAL)
+    if (! not_socket_) [[likely]] {
+        msghdr msg{};
+        msg.msg_iov = const_cast<iovec*>(iov.data()); // sendmsg() doesn't write through it
+        msg.msg_iovlen = iov.size();
+        ssize_t const sz = ::sendmsg(get_fd(), &msg, MSG_NOSIGNAL);
+        if (sz >= 0 || errno != ENOTSOCK) { return sz; }
+        not_socket_ = true;
+    }
+#endif
+    return socket::without_sigpipe([&] { return ::writev(get_fd(), iov.data(), int(iov.size())); });
+}
+
+Task<> Stream::send_fds(std::span<const int> fds)
+{
+    auto result = co_await try_send_fds(fds);
+    result.value();
+}
+
+Task<std::vector<int>> Stream::recv_fds(size_t max_fds)
+{
+    auto fds = co_await try_recv_fds(max_fds);
+    co_return std::move(fds).value();
+}
+
+Task<Expected<void>> Stream::try_send_fds(std::span<const int> fds)
+{
+    char marker = 0;
+    iovec iov{ .iov_base = &marker, .iov_len = 1 };
+    std::vector<char> control(fds.empty() ? 0 : CMSG_SPACE(sizeof(int) * fds.size()));
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    if (! fds.empty()) {
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+        std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+    }
+    std::error_code const timeout = co_await writable();
+    if (timeout) [[unlikely]] { co_return timeout; }
+#if defined(MSG_NOSIGNAL)
+    ssize_t const sz = ::sendmsg(get_fd(), &msg, MSG_NOSIGNAL);
+#else
+    ssize_t const sz = ::sendmsg(get_fd(), &msg, 0);
+#endif
+    if (sz < 0) [[unlikely]] {
+        co_return std::make_error_code(static_cast<std::errc>(errno));
+    }
+    co_return Expected<void>{};
+}
+
+Task<Expected<std::vector<int>>> Stream::try_recv_fds(size_t max_fds)
+{
+    if (max_fds == 0) [[unlikely]] { co_return std::make_error_code(std::errc::invalid_argument); }
+    std::error_code const timeout = co_await readable();
+    if (timeout) [[unlikely]] { co_return timeout; }
+    char marker = 0;
+    iovec iov{ .iov_base = &marker, .iov_len = 1 };
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * max_fds));
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+#if defined(MSG_CMSG_CLOEXEC)
+    ssize_t const sz = ::recvmsg(get_fd(), &msg, MSG_CMSG_CLOEXEC);
+#else
+    ssize_t const sz = ::recvmsg(get_fd(), &msg, 0);
+#endif
+    if (sz < 0) [[unlikely]] {
+        co_return std::make_error_code(static_cast<std::errc>(errno));
+    }
+    std::vector<int> fds;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) { continue; }
+        size_t const count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < count; ++i) {
+            int fd;
+            std::memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+            fds.push_back(fd);
+        }
+    }
+    // CMSG_SPACE() pads the buffer, which may make room for more fds than asked for: those are too many all the same
+    if ((msg.msg_flags & MSG_CTRUNC) || fds.size() > max_fds) [[unlikely]] {
+        for (int fd : fds) { ::close(fd); }
+        co_return std::make_error_code(std::errc::message_size);
+    }
+    co_return std::move(fds);
+}
+
+Task<size_t> Stream::read_some(ChunkedBuffer& buf)
+{
+    std::error_code const timeout = co_await readable();
+    if (timeout) [[unlikely]] { throw std::system_error(timeout); }
+    auto iov = buf.prepare();
+    ssize_t const sz = ::readv(get_fd(), iov.data(), int(iov.size()));
+    if (sz < 0) [[unlikely]] {
+        throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+    }
+    buf.commit(size_t(sz));
+    co_return size_t(sz);
+}
+
+Task<ChunkedBuffer> Stream::read_chunked()
+{
+    ChunkedBuffer result;
+    while (true) {
+        size_t nread = co_await read_some(result);
+        if (nread == 0) { break; }
+    }
+    co_return result;
+}
+
+Task<size_t> Stream::sendfile(int file_fd, off_t offset, size_t count)
+{
+    size_t sent = 0;
+#if defined(__linux__)
+    while (sent < count) {
+        ssize_t const sz = ::sendfile(get_fd(), file_fd, &offset, count - sent);
+        if (sz > 0) {
+            sent += size_t(sz);
+        } else if (sz == 0) {
+            break; // end of file
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            std::error_code const timeout = co_await writable();
+            if (timeout) [[unlikely]] { throw std::system_error(timeout); }
+        } else if (errno != EINTR) [[unlikely]] {
+            throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+        }
+    }
+#else
+    // no sendfile(2) with these semantics: copy through a pooled buffer instead
+    auto buf = get_buffer_pool().acquire(get_buffer_pool().block_size());
+    while (sent < count) {
+        ssize_t const sz = ::pread(file_fd, buf.data(), std::min(buf.capacity(), count - sent), offset);
+        if (sz == 0) { break; }
+        if (sz < 0) [[unlikely]] {
+            if (errno == EINTR) { continue; }
+            throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+        }
+        buf.resize(size_t(sz));
+        co_await write(buf);
+        sent += size_t(sz);
+        offset += sz;
+    }
+#endif
+    co_return sent;
+}
+
+Task<size_t> Stream::writev(std::span<const iovec> iov)
+{
+    iov = iov.first(std::min(iov.size(), size_t(IOV_MAX)));
+    while (true) {
+        ssize_t const sz = writev_some(iov);
+        if (sz >= 0) { co_return size_t(sz); }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) [[unlikely]] {
+            throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+        }
+        std::error_code const timeout = co_await writable();
+        if (timeout) [[unlikely]] { throw std::system_error(timeout); }
+    }
+}
+
+bool Stream::set_zerocopy(bool enable)
+{
+#if defined(__linux__) && defined(SO_ZEROCOPY)
+    if (enable == (zerocopy_ != nullptr)) { return true; }
+    int const on = enable;
+    if (::setsockopt(get_fd(), SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) != 0) { return false; }
+    if (enable) {
+        zerocopy_ = std::make_unique<ZeroCopyState>(get_fd());
+    } else {
+        zerocopy_.reset(); // send_zerocopy() only returns once all completions are in, so there's nothing pending
+    }
+    return true;
+#else
+    return ! enable;
+#endif
+}
+
+Stream::ZeroCopyStats Stream::zerocopy_stats() const
+{
+#if defined(__linux__) && defined(SO_ZEROCOPY)
+    if (zerocopy_) { return zerocopy_->stats; }
+#endif
+    return {};
+}
+
+Task<> Stream::send_zerocopy(std::span<const std::byte> bytes)
+{
+#if defined(__linux__) && defined(SO_ZEROCOPY)
+    if (zerocopy_ && bytes.size() >= zerocopy_threshold) {
+        auto& zc = *zerocopy_;
+        while (! bytes.empty()) {
+            ssize_t const sz = ::send(get_fd(), bytes.data(), bytes.size(), MSG_ZEROCOPY | MSG_NOSIGNAL);
+            if (sz > 0) {
+                ++zc.sent;
+                ++zc.stats.sends;
+                bytes = bytes.subspan(size_t(sz));
+            } else if (sz == 0) [[unlikely]] {
+                throw std::system_error(std::error_code{}, "send() returned 0 bytes; EOF");
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                std::error_code const timeout = co_await writable();
+                if (timeout) [[unlikely]] { throw std::system_error(timeout); }
+            } else if (errno == ENOBUFS && zc.completed != zc.sent) {
+                // out of option memory for pinned pages (net.core.optmem_max): let earlier sends complete first
+                co_await zc.wait_completed(get_fd());
+            } else if (errno != EINTR) [[unlikely]] {
+                throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+            }
+        }
+        co_await zc.wait_completed(get_fd());
+        co_return;
+    }
+#endif
+    co_await write(bytes);
+}
+
+namespace {
+// Drops the first `n` bytes of `iov`, which may end in the middle of one of its buffers. Returns what is left.
+std::span<iovec> consume_iov(std::span<iovec> iov, size_t n) {
+    while (n > 0 && n >= iov.front().iov_len) {
+        n -= iov.front().iov_len;
+        iov = iov.subspan(1);
+    }
+    if (n > 0) {
+        iov.front().iov_base = static_cast<std::byte*>(iov.front().iov_base) + n;
+        iov.front().iov_len -= n;
+    }
+    return iov;
+}
+} // namespace
+
+Task<size_t> Stream::readv_all(std::vector<iovec> iov, bool fill_buffers)
+{
+    std::span<iovec> remaining{iov};
+    size_t nread = 0;
+    while (! remaining.empty()) {
+        std::error_code const timeout = co_await readable();
+        if (timeout) [[unlikely]] { throw std::system_error(timeout); }
+        ssize_t const sz = ::readv(get_fd(), remaining.data(), int(std::min(remaining.size(), size_t(IOV_MAX))));
+        if (sz < 0) [[unlikely]] {
+            throw std::system_error(std::make_error_code(static_cast<std::errc>(errno)));
+        }
+        nread += size_t(sz);
+        if (! fill_buffers || sz == 0) { break; }
+        remaining = consume_iov(remaining, size_t(sz));
+    }
+    co_return nread;
+}
+
+Task<> Stream::writev_all(std::vector<iovec> iov)
+{
+    std::span<iovec> remaining{iov};
+    while (! remaining.empty()) {
+        size_t const sz = co_await writev(remaining); // at most IOV_MAX of them at a time
+        if (sz == 0) [[unlikely]] {
+            throw std::system_error(std::error_code{}, "writev() returned 0 bytes; EOF");
+        }
+        remaining = consume_iov(remaining, sz);
     }
 }
 
@@ -123,7 +670,7 @@ Stream::get_sockaddr(bool peer) const
 uint16_t Stream::get_port(bool peer) const
 {
     const auto &ss = get_sock_info(peer);
-    // Prevent C++ UB, signal compiler about aliasing of `sock_info_`.
+    // Prevent C++ UB, signal compiler about aliasing of `ss`.
     return get_in_port(reinterpret_cast<const sockaddr *>(reinterpret_cast<const std::byte *>(&ss)));
 }
 
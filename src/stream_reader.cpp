@@ -0,0 +1,81 @@
+//
+// Created on 2026/10/18.
+//
+#include <asyncio/stream_reader.h>
+
+#include <algorithm>
+#include <cstring>
+
+ASYNCIO_NS_BEGIN
+
+Task<std::span<const char>> StreamReader::peek(size_t n) {
+    while (end_ - begin_ < n) {
+        bool more = co_await fill(n);
+        if (! more) { break; }
+    }
+    co_return buffered();
+}
+
+void StreamReader::consume(size_t n) {
+    begin_ += std::min(n, end_ - begin_);
+}
+
+Task<std::span<const char>> StreamReader::read(size_t n) {
+    if (begin_ == end_ && n > 0) { co_await fill(1); }
+    co_return take(std::min(n, end_ - begin_));
+}
+
+Task<std::span<const char>> StreamReader::readexactly(size_t n) {
+    while (end_ - begin_ < n) {
+        bool more = co_await fill(n);
+        if (! more) { throw IncompleteReadError{end_ - begin_, n}; }
+    }
+    co_return take(n);
+}
+
+Task<std::span<const char>> StreamReader::readuntil(std::string_view delim) {
+    if (delim.empty()) { co_return take(0); }
+    size_t searched = 0; // don't rescan what was already searched on the previous rounds
+    while (true) {
+        std::string_view data{buf_.data() + begin_, end_ - begin_};
+        auto pos = data.find(delim, searched);
+        if (pos != data.npos) { co_return take(pos + delim.size()); }
+        searched = data.size() >= delim.size() ? data.size() - delim.size() + 1 : 0;
+        if (data.size() >= limit_) { throw LimitOverrunError{data.size()}; }
+        bool more = co_await fill(data.size() + 1);
+        if (! more) { throw IncompleteReadError{data.size(), 0}; }
+    }
+}
+
+std::span<const char> StreamReader::take(size_t n) {
+    std::span<const char> result{buf_.data() + begin_, n};
+    begin_ += n;
+    return result;
+}
+
+Task<bool> StreamReader::fill(size_t want) {
+    if (eof_) { co_return false; }
+    const size_t have = end_ - begin_;
+    if (have == 0) { begin_ = end_ = 0; }
+    // Don't bother reading into a sliver at the tail: move the data to the front, and grow if that's not enough.
+    const size_t room = std::max(want > have ? want - have : 1, std::min(read_size_, buf_.size()) / 4);
+    if (buf_.size() - end_ < room) {
+        if (begin_ > 0) {
+            std::memmove(buf_.data(), buf_.data() + begin_, have);
+            begin_ = 0;
+            end_ = have;
+        }
+        if (buf_.size() - end_ < room) {
+            buf_.resize(std::max(end_ + room, std::max(read_size_, buf_.size() * 2)));
+        }
+    }
+    auto got = co_await stream_.read_in_place(std::span{buf_}.subspan(end_));
+    if (got.empty()) {
+        eof_ = true;
+        co_return false;
+    }
+    end_ += got.size();
+    co_return true;
+}
+
+ASYNCIO_NS_END
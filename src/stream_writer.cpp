@@ -0,0 +1,157 @@
+//
+// Created on 2026/10/18.
+//
+#include <asyncio/stream_writer.h>
+
+#include <asyncio/event_loop.h>
+#include <asyncio/finally.h>
+
+#include <climits>
+#include <cstring>
+#include <utility>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+ASYNCIO_NS_BEGIN
+
+struct StreamWriter::WaitAwaiter : NonCopyable {
+    WaitAwaiter(StreamWriter& writer, size_t threshold): writer_(writer), threshold_(threshold) {}
+    ~WaitAwaiter() {
+        if (waiting_) { std::erase_if(writer_.waiters_, [this](auto& w) { return w.handle == handle_; }); }
+    }
+
+    constexpr bool await_ready() const noexcept { return false; }
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> continuation) noexcept {
+        continuation.promise().set_state(Handle::SUSPEND);
+        handle_ = &continuation.promise();
+        writer_.waiters_.push_back(Waiter{handle_, threshold_});
+        waiting_ = true;
+    }
+    void await_resume() noexcept { waiting_ = false; }
+
+    StreamWriter& writer_;
+    size_t threshold_;
+    CoroHandle* handle_{};
+    bool waiting_{false};
+};
+
+void StreamWriter::write(std::vector<char>&& buf) {
+    rethrow_error();
+    if (buf.empty()) { return; }
+    const size_t size = buf.size();
+    chunks_.push_back(Chunk{ .owned = std::move(buf) });
+    queued(size);
+}
+
+void StreamWriter::write(BufferLease&& buf) {
+    rethrow_error();
+    if (buf.empty()) { return; }
+    const size_t size = buf.size();
+    chunks_.push_back(Chunk{ .lease = std::move(buf) });
+    queued(size);
+}
+
+void StreamWriter::write_borrowed(std::span<const char> buf) {
+    rethrow_error();
+    if (buf.empty()) { return; }
+    chunks_.push_back(Chunk{ .borrowed = buf });
+    queued(buf.size());
+}
+
+void StreamWriter::write_copy(std::span<const std::byte> bytes) {
+    rethrow_error();
+    if (bytes.empty()) { return; }
+    if (chunks_.empty() || ! chunks_.back().coalesce) {
+        chunks_.push_back(Chunk{ .coalesce = true });
+    }
+    auto& owned = chunks_.back().owned;
+    const size_t pos = owned.size();
+    owned.resize(pos + bytes.size());
+    std::memcpy(owned.data() + pos, bytes.data(), bytes.size());
+    queued(bytes.size());
+}
+
+void StreamWriter::queued(size_t size) {
+    buffered_ += size;
+    if (options_.auto_flush) { start_flush(); }
+}
+
+Task<> StreamWriter::drain() {
+    rethrow_error();
+    if (buffered_ > options_.high_water) {
+        start_flush();
+        co_await WaitAwaiter{*this, options_.low_water};
+        rethrow_error();
+    }
+}
+
+Task<> StreamWriter::flush() {
+    rethrow_error();
+    if (buffered_ > 0) {
+        start_flush();
+        co_await WaitAwaiter{*this, 0};
+        rethrow_error();
+    }
+}
+
+void StreamWriter::start_flush() {
+    if (! flushing_) {
+        flushing_ = true;
+        // scheduled rather than run right away, so that it picks up everything written during this loop tick
+        flusher_.emplace(schedule_task(flush_queue()));
+    }
+}
+
+Task<> StreamWriter::flush_queue() {
+    finally { flushing_ = false; };
+    try {
+        while (! chunks_.empty()) {
+            iov_.clear();
+            size_t skip = sent_from_front_;
+            for (auto& chunk : chunks_) {
+                if (iov_.size() == IOV_MAX) { break; }
+                auto data = chunk.data().subspan(std::exchange(skip, 0));
+                iov_.push_back(iovec{ .iov_base = const_cast<char*>(data.data()), .iov_len = data.size() });
+            }
+            // writev() may have to wait, and appending to a buffer that's being sent could move it meanwhile
+            chunks_.back().coalesce = false;
+            size_t sent = co_await stream_.writev(iov_);
+            ++stats_.syscalls;
+            stats_.bytes += sent;
+            consume(sent);
+            wake_waiters();
+        }
+    } catch (...) {
+        error_ = std::current_exception();
+        chunks_.clear();
+        sent_from_front_ = buffered_ = 0;
+        wake_waiters();
+    }
+}
+
+void StreamWriter::consume(size_t sent) {
+    buffered_ -= sent;
+    sent += sent_from_front_;
+    while (! chunks_.empty() && sent >= chunks_.front().data().size()) {
+        sent -= chunks_.front().data().size();
+        chunks_.pop_front();
+    }
+    sent_from_front_ = sent;
+}
+
+void StreamWriter::wake_waiters() {
+    std::erase_if(waiters_, [this](const Waiter& w) {
+        if (buffered_ > w.threshold) { return false; }
+        get_event_loop().call_soon(*w.handle);
+        return true;
+    });
+}
+
+void StreamWriter::rethrow_error() const {
+    if (error_) { std::rethrow_exception(error_); }
+}
+
+ASYNCIO_NS_END
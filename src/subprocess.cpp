@@ -0,0 +1,261 @@
+//
+// Created on 2026/10/18.
+//
+#include <asyncio/subprocess.h>
+#include <asyncio/event_loop.h>
+#include <asyncio/finally.h>
+#include <asyncio/gather.h>
+#include <asyncio/sleep.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 34)
+#define HAVE_SPAWN_CLOSEFROM 1
+#endif
+#endif
+
+extern char** environ;
+
+ASYNCIO_NS_BEGIN
+
+namespace {
+[[noreturn]] void throw_error(int error) {
+    throw std::system_error(std::make_error_code(static_cast<std::errc>(error)));
+}
+
+void close_fd(int& fd) {
+    if (fd != -1) { ::close(fd); }
+    fd = -1;
+}
+
+int pidfd_open(pid_t pid) {
+#if defined(SYS_pidfd_open)
+    int const fd = int(::syscall(SYS_pidfd_open, pid, 0));
+    if (fd != -1) { ::fcntl(fd, F_SETFD, FD_CLOEXEC); }
+    return fd;
+#else
+    return -1;
+#endif
+}
+
+// The fds for one of the child's standard streams: ours (a pipe end) and the child's
+struct Redirection {
+    int parent{-1};
+    int child{-1};
+    ~Redirection() {
+        close_fd(parent);
+        close_fd(child);
+    }
+};
+
+void redirect(SubprocessOptions::Redirect how, int target, Redirection& redirection,
+              posix_spawn_file_actions_t& actions) {
+    using Redirect = SubprocessOptions::Redirect;
+    switch (how) {
+        case Redirect::inherit:
+            return;
+        case Redirect::devnull:
+            ::posix_spawn_file_actions_addopen(&actions, target, "/dev/null", target == STDIN_FILENO ? O_RDONLY : O_WRONLY, 0);
+            return;
+        case Redirect::pipe: {
+            int fds[2];
+            if (::pipe2(fds, O_CLOEXEC) != 0) { throw_error(errno); }
+            bool const child_reads = target == STDIN_FILENO;
+            redirection.child = fds[child_reads ? 0 : 1];
+            redirection.parent = fds[child_reads ? 1 : 0];
+            ::fcntl(redirection.parent, F_SETFL, ::fcntl(redirection.parent, F_GETFL) | O_NONBLOCK);
+            // dup2() clears close-on-exec on the copy the child keeps
+            ::posix_spawn_file_actions_adddup2(&actions, redirection.child, target);
+            return;
+        }
+    }
+}
+} // namespace
+
+Subprocess create_subprocess_exec(const std::string& program, const std::vector<std::string>& args,
+                                  const SubprocessOptions& options)
+{
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(program.c_str()));
+    for (auto& arg : args) { argv.push_back(const_cast<char*>(arg.c_str())); }
+    argv.push_back(nullptr);
+    std::vector<char*> envp;
+    if (options.env) {
+        for (auto& var : *options.env) { envp.push_back(const_cast<char*>(var.c_str())); }
+        envp.push_back(nullptr);
+    }
+
+    posix_spawn_file_actions_t actions;
+    ::posix_spawn_file_actions_init(&actions);
+    posix_spawnattr_t attr;
+    ::posix_spawnattr_init(&attr);
+    struct Cleanup {
+        posix_spawn_file_actions_t& actions;
+        posix_spawnattr_t& attr;
+        ~Cleanup() {
+            ::posix_spawn_file_actions_destroy(&actions);
+            ::posix_spawnattr_destroy(&attr);
+        }
+    } cleanup{actions, attr};
+
+    Redirection in, out, err;
+    redirect(options.stdin_to, STDIN_FILENO, in, actions);
+    redirect(options.stdout_to, STDOUT_FILENO, out, actions);
+    redirect(options.stderr_to, STDERR_FILENO, err, actions);
+#if defined(HAVE_SPAWN_CLOSEFROM)
+    // our fds are close-on-exec, but those of other libraries in the process may not be
+    ::posix_spawn_file_actions_addclosefrom_np(&actions, STDERR_FILENO + 1);
+#endif
+
+    // signals blocked for a signalfd (see signal.h), or ignored SIGPIPE, aren't the child's business
+    sigset_t none, defaults;
+    sigemptyset(&none);
+    sigemptyset(&defaults);
+    sigaddset(&defaults, SIGPIPE);
+    ::posix_spawnattr_setsigmask(&attr, &none);
+    ::posix_spawnattr_setsigdefault(&attr, &defaults);
+    ::posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+    pid_t pid = -1;
+    // glibc's posix_spawn() is a clone(CLONE_VM | CLONE_VFORK), and reports exec failures
+    int const rc = ::posix_spawnp(&pid, program.c_str(), &actions, &attr, argv.data(),
+                                  options.env ? envp.data() : environ);
+    if (rc != 0) { throw_error(rc); }
+
+    Subprocess process{pid, pidfd_open(pid)};
+    if (in.parent != -1) { process.stdin_pipe.emplace(std::exchange(in.parent, -1)); }
+    if (out.parent != -1) { process.stdout_pipe.emplace(std::exchange(out.parent, -1)); }
+    if (err.parent != -1) { process.stderr_pipe.emplace(std::exchange(err.parent, -1)); }
+    return process;
+}
+
+Subprocess::Subprocess(Subprocess&& other)
+    : stdin_pipe(std::move(other.stdin_pipe)),
+      stdout_pipe(std::move(other.stdout_pipe)),
+      stderr_pipe(std::move(other.stderr_pipe)),
+      pid_(std::exchange(other.pid_, -1)),
+      pidfd_(std::exchange(other.pidfd_, -1)),
+      returncode_(other.returncode_)
+{
+    other.stdin_pipe.reset();
+    other.stdout_pipe.reset();
+    other.stderr_pipe.reset();
+}
+
+Subprocess::~Subprocess()
+{
+    // reap it if it is done already, there is no waiting here
+    if (pid_ != -1 && ! returncode_) {
+        int status = 0;
+        if (::waitpid(pid_, &status, WNOHANG) == pid_) { reaped(status); }
+    }
+    close_fd(pidfd_);
+}
+
+void Subprocess::reaped(int status)
+{
+    returncode_ = WIFSIGNALED(status) ? -WTERMSIG(status) : WEXITSTATUS(status);
+    close_fd(pidfd_);
+}
+
+struct Subprocess::WatcherAwaiter : NonCopyable {
+    explicit WatcherAwaiter(Subprocess& process) : process_(process) { }
+    ~WatcherAwaiter() { std::erase(process_.waiters_, waiter_); }
+
+    constexpr bool await_ready() const noexcept { return false; }
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        handle.promise().set_state(Handle::SUSPEND);
+        waiter_ = &handle.promise();
+        process_.waiters_.push_back(waiter_);
+    }
+    constexpr void await_resume() const noexcept { }
+
+    Subprocess& process_;
+    CoroHandle* waiter_{};
+};
+
+Task<int> Subprocess::wait()
+{
+    while (! returncode_) {
+        if (watching_) {
+            // if the watching wait() fails or goes away instead, the next one of us takes over
+            co_await WatcherAwaiter{*this};
+            continue;
+        }
+        watching_ = true;
+        finally {
+            watching_ = false;
+            for (auto waiter : std::exchange(waiters_, {})) { get_event_loop().call_soon(*waiter); }
+        };
+        co_await watch();
+    }
+    co_return *returncode_;
+}
+
+Task<> Subprocess::watch()
+{
+    while (! returncode_) {
+        if (pid_ == -1) [[unlikely]] { throw_error(ECHILD); }
+        int status = 0;
+        pid_t const rc = ::waitpid(pid_, &status, WNOHANG);
+        if (rc == pid_) {
+            reaped(status);
+        } else if (rc == -1 && errno != EINTR) [[unlikely]] {
+            throw_error(errno);
+        } else if (pidfd_ != -1) {
+            // readable once the process exited
+            co_await get_event_loop().wait_readable(pidfd_);
+        } else {
+            co_await ASYNCIO_NS::sleep(std::chrono::milliseconds(10));
+        }
+    }
+}
+
+void Subprocess::send_signal(int signo)
+{
+    if (pid_ == -1 || returncode_) { return; }
+#if defined(SYS_pidfd_send_signal)
+    if (pidfd_ != -1) {
+        ::syscall(SYS_pidfd_send_signal, pidfd_, signo, nullptr, 0);
+        return;
+    }
+#endif
+    ::kill(pid_, signo);
+}
+
+Task<std::pair<std::string, std::string>> Subprocess::communicate(std::string_view input)
+{
+    auto feed = [&]() -> Task<> {
+        if (! stdin_pipe) { co_return; }
+        if (! input.empty()) {
+            auto written = co_await stdin_pipe->try_write(input);
+            // a child that doesn't read all of its input is no error
+            if (! written && written.error() != std::errc::broken_pipe) { written.value(); }
+        }
+        stdin_pipe.reset();
+    };
+    auto drain = [](std::optional<Stream>& pipe) -> Task<std::string> {
+        if (! pipe) { co_return std::string{}; }
+        auto data = co_await pipe->read<std::string>();
+        pipe.reset();
+        co_return data;
+    };
+    auto [_, out, err] = co_await ASYNCIO_NS::gather(feed(), drain(stdout_pipe), drain(stderr_pipe));
+    co_await wait();
+    co_return std::pair{std::move(out), std::move(err)};
+}
+
+ASYNCIO_NS_END
@@ -0,0 +1,67 @@
+//
+// Created on 2026/10/18.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <nanobench.h>
+#include <asyncio/datagram.h>
+#include <asyncio/runner.h>
+#include <asyncio/task.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using asyncio::Datagram;
+using asyncio::DatagramOptions;
+using asyncio::Task;
+
+namespace {
+constexpr size_t window = 64; // datagrams in flight, few enough for the receive buffer not to drop any
+
+// Sends `count` datagrams of `size` bytes over loopback, `window` at a time, each window received before the next is
+// sent. With GSO, each window goes out as one train of segments.
+void ping(size_t count, size_t size, size_t batch_size, bool gso) {
+    asyncio::run([&]() -> Task<> {
+        DatagramOptions const server_options{ .batch_size = batch_size };
+        DatagramOptions const client_options{ .batch_size = batch_size, .gso = gso };
+        auto server = co_await asyncio::create_datagram_endpoint("127.0.0.1", 0, server_options);
+        auto client = co_await asyncio::connect_datagram_endpoint("127.0.0.1", server.get_port(), client_options);
+        std::vector<Datagram> sent;
+        if (gso) {
+            // at most 64 segments, and 64KB, per send
+            size_t const per_send = std::min<size_t>(64, 65000 / size);
+            for (size_t i = 0; i < window; i += per_send) {
+                size_t const segments = std::min(per_send, window - i);
+                sent.push_back(Datagram{ .data = asyncio::BufferLease(segments * size), .segment_size = uint16_t(size) });
+            }
+        } else {
+            for (size_t i = 0; i < window; ++i) { sent.push_back(Datagram{ .data = asyncio::BufferLease(size) }); }
+        }
+        for (auto& d : sent) { std::memset(d.data.data(), 'x', d.data.size()); }
+
+        for (size_t done = 0; done < count; done += window) {
+            co_await client.send_batch(sent);
+            size_t received = 0;
+            while (received < window) {
+                auto batch = co_await server.recv_batch();
+                received += batch.size();
+            }
+        }
+    }());
+}
+}
+
+SCENARIO("UDP loopback packets per second") {
+    constexpr size_t count = 200 * window;
+    for (size_t size : {64, 1200}) {
+        ankerl::nanobench::Bench bench;
+        bench.title(fmt::format("{} byte datagrams", size)).unit("datagram").batch(count).relative(true);
+        bench.run("batch size 1", [&] { ping(count, size, 1, false); });
+        bench.run("batch size 16", [&] { ping(count, size, 16, false); });
+        bench.run("batch size 64", [&] { ping(count, size, 64, false); });
+        bench.run("batch size 64 + GSO", [&] { ping(count, size, 64, true); });
+    }
+}
@@ -0,0 +1,74 @@
+//
+// Created on 2026/10/18.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <nanobench.h>
+#include <asyncio/runner.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+
+#include <fmt/format.h>
+
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+using asyncio::Stream;
+using asyncio::Task;
+
+namespace {
+// Reads from `count` connections that the peer reset, as if `count` clients disconnected at once, either catching the
+// std::system_error of read_in_place() or checking the result of try_read_in_place(). Returns how many were seen.
+size_t reset_storm(size_t count, bool use_error_codes) {
+    size_t resets = 0;
+    asyncio::run([&]() -> Task<> {
+        std::vector<char> buf(64);
+        for (size_t i = 0; i < count; ++i) {
+            int fds[2];
+            ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds);
+            // closing a unix socket with unread data resets the connection: our read fails with ECONNRESET
+            ::write(fds[0], "x", 1);
+            ::close(fds[1]);
+            Stream stream{fds[0]};
+            if (use_error_codes) {
+                auto result = co_await stream.try_read_in_place(std::span{buf});
+                if (! result) { ++resets; }
+            } else {
+                try {
+                    co_await stream.read_in_place(std::span{buf});
+                } catch (const std::system_error&) {
+                    ++resets;
+                }
+            }
+        }
+    }());
+    return resets;
+}
+
+// the same, spread over `threads` event loops
+void parallel_reset_storm(size_t count, size_t threads, bool use_error_codes) {
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([=] { reset_storm(count / threads, use_error_codes); });
+    }
+    for (auto& worker : workers) { worker.join(); }
+}
+}
+
+SCENARIO("connection resets: exceptions vs error codes") {
+    constexpr size_t batch = 10'000;
+    REQUIRE(reset_storm(10, true) == 10);
+    REQUIRE(reset_storm(10, false) == 10);
+
+    for (size_t threads : {1, 4}) {
+        ankerl::nanobench::Bench bench;
+        bench.title(fmt::format("{} resets on {} thread(s)", batch, threads)).unit("reset").batch(batch).relative(true);
+        bench.run("read_in_place + catch", [&] { parallel_reset_storm(batch, threads, false); });
+        bench.run("try_read_in_place", [&] { parallel_reset_storm(batch, threads, true); });
+    }
+}
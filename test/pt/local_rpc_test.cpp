@@ -0,0 +1,102 @@
+//
+// Created on 2026/10/18.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <nanobench.h>
+#include <asyncio/gather.h>
+#include <asyncio/memory_stream.h>
+#include <asyncio/runner.h>
+#include <asyncio/shm_channel.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+
+#include <fmt/format.h>
+
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using asyncio::ShmChannel;
+using asyncio::Stream;
+using asyncio::Task;
+
+namespace {
+// a connected pair of loopback TCP sockets, with Nagle off as RPC clients would have it
+std::pair<int, int> tcp_pair() {
+    int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in sin{ .sin_family = AF_INET, .sin_port = 0 };
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(listener, reinterpret_cast<sockaddr*>(&sin), sizeof(sin));
+    ::listen(listener, 1);
+    socklen_t len = sizeof(sin);
+    ::getsockname(listener, reinterpret_cast<sockaddr*>(&sin), &len);
+    int client = ::socket(AF_INET, SOCK_STREAM, 0);
+    ::connect(client, reinterpret_cast<sockaddr*>(&sin), sizeof(sin));
+    int server = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+    ::close(listener);
+    ::fcntl(client, F_SETFL, ::fcntl(client, F_GETFL) | O_NONBLOCK);
+    int yes = 1;
+    ::setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    ::setsockopt(server, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    return {client, server};
+}
+
+std::pair<int, int> unix_pair() {
+    int fds[2];
+    ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds);
+    return {fds[0], fds[1]};
+}
+
+std::pair<Stream, Stream> streams(std::pair<int, int> fds) {
+    return {Stream{fds.first}, Stream{fds.second}};
+}
+
+std::pair<ShmChannel, ShmChannel> shm_pair() {
+    auto creator = ShmChannel::create();
+    auto fds = creator.peer_fds();
+    auto attached = ShmChannel::attach(fds);
+    return {std::move(creator), std::move(attached)};
+}
+
+// `count` request/response round trips of `size` bytes each way, between both ends of `open()`
+template <typename Open>
+void rpc(size_t count, size_t size, Open open) {
+    asyncio::run([&]() -> Task<> {
+        auto [client, server] = open();
+        auto call = [&]() -> Task<> {
+            std::vector<char> request(size, 'q'), response(size);
+            for (size_t i = 0; i < count; ++i) {
+                co_await client.write(request);
+                co_await client.read_in_place(std::span{response}, true);
+            }
+        };
+        auto serve = [&]() -> Task<> {
+            std::vector<char> buf(size);
+            for (size_t i = 0; i < count; ++i) {
+                co_await server.read_in_place(std::span{buf}, true);
+                co_await server.write(buf);
+            }
+        };
+        co_await asyncio::gather(call(), serve());
+    }());
+}
+}
+
+SCENARIO("local RPC: loopback TCP vs unix domain sockets vs shared memory") {
+    constexpr size_t count = 10'000;
+    for (size_t size : {64, 16 * 1024}) {
+        ankerl::nanobench::Bench bench;
+        bench.title(fmt::format("{} byte round trips", size)).unit("round trip").batch(count).relative(true);
+        bench.run("loopback TCP", [&] { rpc(count, size, [] { return streams(tcp_pair()); }); });
+        bench.run("AF_UNIX", [&] { rpc(count, size, [] { return streams(unix_pair()); }); });
+        bench.run("ShmChannel", [&] { rpc(count, size, shm_pair); });
+        bench.run("memory_stream_pair (no kernel)", [&] { rpc(count, size, [] { return asyncio::memory_stream_pair(); }); });
+    }
+}
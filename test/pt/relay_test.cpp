@@ -0,0 +1,98 @@
+//
+// Created on 2026/10/18.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <nanobench.h>
+#include <asyncio/gather.h>
+#include <asyncio/relay.h>
+#include <asyncio/runner.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+
+#include <fmt/format.h>
+
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using asyncio::Stream;
+using asyncio::Task;
+
+namespace {
+// a connected pair of loopback TCP sockets
+std::pair<int, int> tcp_pair() {
+    int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in sin{ .sin_family = AF_INET, .sin_port = 0 };
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(listener, reinterpret_cast<sockaddr*>(&sin), sizeof(sin));
+    ::listen(listener, 1);
+    socklen_t len = sizeof(sin);
+    ::getsockname(listener, reinterpret_cast<sockaddr*>(&sin), &len);
+    int client = ::socket(AF_INET, SOCK_STREAM, 0);
+    ::connect(client, reinterpret_cast<sockaddr*>(&sin), sizeof(sin));
+    int server = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+    ::close(listener);
+    ::fcntl(client, F_SETFL, ::fcntl(client, F_GETFL) | O_NONBLOCK);
+    return {client, server};
+}
+
+Task<size_t> copy_loop(Stream& src, Stream& dst) {
+    std::vector<char> buf(64 * 1024);
+    size_t total = 0;
+    while (true) {
+        auto data = co_await src.read_in_place(std::span{buf});
+        if (data.empty()) { break; }
+        co_await dst.write(data);
+        total += data.size();
+    }
+    dst.shutdown(SHUT_WR);
+    co_return total;
+}
+
+// client -> proxy -> server, `size` bytes through either relay() or a read() + write() loop per direction
+void proxy_transfer(size_t size, bool use_relay) {
+    asyncio::run([&]() -> Task<> {
+        auto [c, pc] = tcp_pair();
+        auto [ps, s] = tcp_pair();
+        Stream client{c}, proxy_client{pc}, proxy_server{ps}, server{s};
+        auto proxy = [&]() -> Task<> {
+            if (use_relay) {
+                co_await asyncio::relay(proxy_client, proxy_server);
+            } else {
+                co_await asyncio::gather(copy_loop(proxy_client, proxy_server), copy_loop(proxy_server, proxy_client));
+            }
+        };
+        auto send = [&]() -> Task<> {
+            std::vector<char> buf(size, 'x');
+            co_await client.write(buf);
+            client.shutdown(SHUT_WR);
+            auto rest = co_await client.read();
+        };
+        auto receive = [&]() -> Task<> {
+            std::vector<char> buf(256 * 1024);
+            while (true) {
+                auto data = co_await server.read_in_place(std::span{buf});
+                if (data.empty()) { break; }
+            }
+            server.shutdown(SHUT_WR);
+        };
+        co_await asyncio::gather(proxy(), send(), receive());
+    }());
+}
+}
+
+SCENARIO("proxy throughput: relay vs copy loop") {
+    for (size_t size : {64 * 1024, 1024 * 1024, 64 * 1024 * 1024}) {
+        ankerl::nanobench::Bench bench;
+        bench.title(fmt::format("proxy {} bytes", size)).unit("byte").batch(size).relative(true);
+        bench.minEpochIterations(size >= 64 * 1024 * 1024 ? 1 : 10);
+        bench.run("read + write loop", [&] { proxy_transfer(size, false); });
+        bench.run("splice relay", [&] { proxy_transfer(size, true); });
+    }
+}
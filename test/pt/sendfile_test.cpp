@@ -0,0 +1,77 @@
+//
+// Created on 2026/10/18.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <nanobench.h>
+#include <asyncio/gather.h>
+#include <asyncio/runner.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+using asyncio::Stream;
+using asyncio::Task;
+
+namespace {
+// Sends `size` bytes of a file over a socket pair, either with Stream::sendfile or with read() + write(), while the
+// other end drains them.
+void send_file(int file_fd, size_t size, bool use_sendfile) {
+    asyncio::run([&]() -> Task<> {
+        int fds[2];
+        ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds);
+        Stream reading{fds[0]}, writing{fds[1]};
+        auto sender = [&]() -> Task<> {
+            if (use_sendfile) {
+                co_await writing.sendfile(file_fd, 0, size);
+            } else {
+                std::vector<char> buf(64 * 1024);
+                for (off_t offset = 0; size_t(offset) < size; ) {
+                    ssize_t n = ::pread(file_fd, buf.data(), buf.size(), offset);
+                    if (n <= 0) { break; }
+                    co_await writing.write(std::span{buf.data(), size_t(n)});
+                    offset += n;
+                }
+            }
+            writing.close();
+        };
+        auto receiver = [&]() -> Task<> {
+            std::vector<char> buf(256 * 1024);
+            while (true) {
+                auto data = co_await reading.read_in_place(std::span{buf});
+                if (data.empty()) { break; }
+            }
+        };
+        co_await asyncio::gather(sender(), receiver());
+    }());
+}
+}
+
+SCENARIO("sendfile vs read + write") {
+    std::vector<size_t> sizes{1024, 64 * 1024, 1024 * 1024, 64 * 1024 * 1024};
+    if (std::getenv("ASYNCIO_BENCH_LARGE")) { sizes.push_back(1024 * 1024 * 1024); } // needs 1 GB in /tmp
+
+    for (size_t size : sizes) {
+        char path[] = "/tmp/asyncio_pt_XXXXXX";
+        int fd = ::mkstemp(path);
+        ::unlink(path);
+        std::vector<char> block(1024 * 1024, 'x');
+        for (size_t written = 0; written < size; written += std::min(block.size(), size - written)) {
+            ::write(fd, block.data(), std::min(block.size(), size - written));
+        }
+
+        ankerl::nanobench::Bench bench;
+        bench.title(fmt::format("send {} bytes", size)).unit("byte").batch(size).relative(true);
+        bench.minEpochIterations(size >= 64 * 1024 * 1024 ? 1 : 10);
+        bench.run("read + write", [&] { send_file(fd, size, false); });
+        bench.run("sendfile", [&] { send_file(fd, size, true); });
+        ::close(fd);
+    }
+}
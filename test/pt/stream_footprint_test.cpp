@@ -0,0 +1,128 @@
+//
+// Created on 2026/10/18.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/runner.h>
+#include <asyncio/schedule_task.h>
+#include <asyncio/sleep.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+
+#include <fmt/format.h>
+
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <malloc.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using asyncio::ScheduledTask;
+using asyncio::Stream;
+using asyncio::Task;
+using namespace std::chrono;
+
+namespace {
+constexpr size_t million = 1'000'000;
+
+// large blocks (like a vector of a million Streams) are mmap()ed, so those count too
+size_t heap_in_use() {
+    auto const info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+// as many connections as the fd limit allows, leaving some headroom: two fds per socket pair
+size_t max_connections() {
+    rlimit limit{};
+    ::getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    ::setrlimit(RLIMIT_NOFILE, &limit);
+    return std::min<size_t>((limit.rlim_cur - 64) / 2, 100'000);
+}
+
+// resident memory of this process, in bytes
+size_t rss() {
+    size_t pages = 0, resident = 0;
+    if (FILE* statm = ::fopen("/proc/self/statm", "r")) {
+        if (::fscanf(statm, "%zu %zu", &pages, &resident) != 2) { resident = 0; }
+        ::fclose(statm);
+    }
+    return resident * size_t(::sysconf(_SC_PAGESIZE));
+}
+
+void report(const std::string& what, size_t bytes, size_t count) {
+    double const per_connection = double(bytes) / double(count);
+    fmt::print("{}: {:.0f} bytes per idle connection, {:.1f} MiB at 1M connections\n",
+               what, per_connection, per_connection * million / (1024 * 1024));
+}
+
+// How the handler of each connection waits for its next request.
+enum class Idle { wait_readable, read_pooled, read };
+constexpr const char* idle_names[] = { "wait_readable()", "read_pooled()", "read(16K)" };
+
+Task<> handler(Stream& stream, Idle idle) {
+    switch (idle) {
+    case Idle::wait_readable: co_await stream.wait_readable(); break;
+    case Idle::read_pooled: { auto data = co_await stream.read_pooled(); break; }
+    case Idle::read: { auto data = co_await stream.read(16 * 1024); break; }
+    }
+}
+
+// A server's view: one Stream per connection, each with a handler waiting for data. The fd limit caps these well below
+// a million, so the per connection cost is extrapolated. Runs in a child process, so that memory freed by a previous
+// run can't hide what this one needs.
+void idle_connections(size_t count, Idle idle) {
+    std::fflush(stdout);
+    pid_t const child = ::fork();
+    if (child != 0) {
+        ::waitpid(child, nullptr, 0);
+        return;
+    }
+    asyncio::run([&]() -> Task<> {
+        std::vector<int> peers;
+        peers.reserve(count);
+        size_t const heap_before = heap_in_use(), rss_before = rss();
+        std::deque<Stream> streams;
+        std::deque<ScheduledTask<Task<>>> handlers;
+        for (size_t i = 0; i < count; ++i) {
+            int fds[2];
+            ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds);
+            peers.push_back(fds[1]);
+            handlers.emplace_back(handler(streams.emplace_back(fds[0]), idle));
+        }
+        co_await asyncio::sleep(1ms); // let every handler start waiting
+        std::string const what = fmt::format("{} ({} connections)", idle_names[size_t(idle)], count);
+        report(what + " heap", heap_in_use() - heap_before, count);
+        report(what + " RSS", rss() - rss_before, count);
+
+        for (int peer : peers) { ::write(peer, "x", 1); }
+        for (auto& handler : handlers) { co_await handler; }
+        for (int peer : peers) { ::close(peer); }
+    }());
+    std::fflush(stdout);
+    ::_exit(0);
+}
+}
+
+SCENARIO("memory per idle connection") {
+    fmt::print("sizeof(Stream): {} bytes\n", sizeof(Stream));
+
+    // the Stream objects alone, for a full million connections
+    {
+        size_t const before = heap_in_use();
+        std::vector<Stream> streams;
+        streams.reserve(million);
+        for (size_t i = 0; i < million; ++i) { streams.emplace_back(-1); }
+        report("Stream", heap_in_use() - before, million);
+    }
+
+    size_t const count = max_connections();
+    for (Idle idle : {Idle::wait_readable, Idle::read_pooled, Idle::read}) {
+        idle_connections(count, idle);
+    }
+}
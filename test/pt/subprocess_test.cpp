@@ -0,0 +1,63 @@
+//
+// Created on 2026/10/18.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <nanobench.h>
+#include <asyncio/runner.h>
+#include <asyncio/subprocess.h>
+#include <asyncio/task.h>
+
+#include <fmt/format.h>
+
+#include <cstring>
+#include <memory>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using asyncio::SubprocessOptions;
+using asyncio::Task;
+
+namespace {
+constexpr size_t count = 50;
+
+SubprocessOptions const quiet{ .stdin_to = SubprocessOptions::Redirect::devnull,
+                               .stdout_to = SubprocessOptions::Redirect::devnull };
+
+void spawn() {
+    asyncio::run([]() -> Task<> {
+        for (size_t i = 0; i < count; ++i) {
+            auto child = asyncio::create_subprocess_exec("true", {}, quiet);
+            co_await child.wait();
+        }
+    }());
+}
+
+// what spawning used to look like: fork(), which copies the page tables of all of our memory, then exec
+void fork_exec() {
+    for (size_t i = 0; i < count; ++i) {
+        pid_t const pid = ::fork();
+        if (pid == 0) {
+            ::execlp("true", "true", nullptr);
+            ::_exit(127);
+        }
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+    }
+}
+}
+
+SCENARIO("spawning subprocesses from a process with a large RSS") {
+    for (size_t mib : {0, 256, 1024}) {
+        // resident, not just reserved: every page touched
+        size_t const size = mib * 1024 * 1024;
+        std::unique_ptr<char[]> memory{new char[size + 1]};
+        std::memset(memory.get(), 1, size + 1);
+
+        ankerl::nanobench::Bench bench;
+        bench.title(fmt::format("{} MiB resident", mib)).unit("spawn").batch(count).relative(true);
+        bench.run("fork + exec", fork_exec);
+        bench.run("create_subprocess_exec (posix_spawn)", spawn);
+    }
+}
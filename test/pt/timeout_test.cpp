@@ -0,0 +1,69 @@
+//
+// Created on 2026/10/18.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <nanobench.h>
+#include <asyncio/gather.h>
+#include <asyncio/runner.h>
+#include <asyncio/stream.h>
+#include <asyncio/task.h>
+#include <asyncio/wait_for.h>
+
+#include <chrono>
+#include <string_view>
+#include <vector>
+
+#include <sys/socket.h>
+
+using asyncio::Stream;
+using asyncio::Task;
+using namespace std::chrono;
+using namespace std::string_view_literals;
+
+namespace {
+enum class Deadline { none, wait_for, stream };
+
+// `count` one byte ping-pongs over a socket pair, the reads guarded by a 10s timeout the way `deadline` says
+void ping_pong(size_t count, Deadline deadline) {
+    asyncio::run([&]() -> Task<> {
+        int fds[2];
+        ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds);
+        Stream a{fds[0]}, b{fds[1]};
+        if (deadline == Deadline::stream) {
+            a.set_read_timeout(10s);
+            b.set_read_timeout(10s);
+        }
+        auto read_one = [&](Stream& stream) -> Task<> {
+            std::vector<char> buf(1);
+            if (deadline == Deadline::wait_for) {
+                co_await asyncio::wait_for(stream.read_in_place(std::span{buf}), 10s);
+            } else {
+                co_await stream.read_in_place(std::span{buf});
+            }
+        };
+        auto pinger = [&]() -> Task<> {
+            for (size_t i = 0; i < count; ++i) {
+                co_await a.write("x"sv);
+                co_await read_one(a);
+            }
+        };
+        auto ponger = [&]() -> Task<> {
+            for (size_t i = 0; i < count; ++i) {
+                co_await read_one(b);
+                co_await b.write("x"sv);
+            }
+        };
+        co_await asyncio::gather(pinger(), ponger());
+    }());
+}
+}
+
+SCENARIO("read timeouts: wait_for vs Stream::set_read_timeout") {
+    constexpr size_t count = 10'000;
+    ankerl::nanobench::Bench bench;
+    bench.title("ping-pong with read timeouts").unit("round trip").batch(count).relative(true);
+    bench.run("no timeout", [&] { ping_pong(count, Deadline::none); });
+    bench.run("wait_for", [&] { ping_pong(count, Deadline::wait_for); });
+    bench.run("set_read_timeout", [&] { ping_pong(count, Deadline::stream); });
+}
@@ -1,3 +1,4 @@
+#include <asyncio/buffer_pool.h>
 #include <asyncio/stream.h>
 #include <arpa/inet.h>
 #include <asyncio/runner.h>
@@ -5,6 +6,7 @@
 #include <asyncio/task.h>
 #include <fmt/core.h>
 
+using asyncio::BufferLease;
 using asyncio::Stream;
 using asyncio::Task;
 using asyncio::get_in_port;
@@ -14,7 +16,7 @@ int add_count = 0;
 int rel_count = 0;
 
 Task<> handle_echo(Stream stream) {
-    auto sockinfo = stream.get_sock_info();
+    auto sockinfo = stream.get_sock_info(true);
     char addr[INET6_ADDRSTRLEN] {};
     auto sa = reinterpret_cast<const sockaddr*>(&sockinfo);
 
@@ -22,7 +24,8 @@ Task<> handle_echo(Stream stream) {
     // fmt::print("connections: {}/{}\n", rel_count, add_count);
     while (true) {
         try {
-            auto data = co_await stream.read(200);
+            // pooled buffer: echoing doesn't allocate once the pool is warm
+            auto data = co_await stream.read<BufferLease>(200);
             if (data.empty()) { break; }
             // fmt::print("Received: '{}' from '{}:{}'\n", data.data(),
                     // inet_ntop(sockinfo.ss_family, get_in_addr(sa), addr, sizeof addr),
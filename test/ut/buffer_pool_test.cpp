@@ -0,0 +1,104 @@
+//
+// Created on 2026/10/18.
+//
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/buffer_pool.h>
+#include <asyncio/runner.h>
+#include <asyncio/stream.h>
+#include <asyncio/stream_writer.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include <sys/socket.h>
+
+using namespace ASYNCIO_NS;
+using namespace std::string_view_literals;
+
+SCENARIO("buffer pool") {
+    BufferPool pool{1024, 4};
+
+    GIVEN("blocks are reused") {
+        const char* first;
+        {
+            auto lease = pool.acquire(100);
+            first = lease.data();
+            REQUIRE(lease.size() == 100);
+            REQUIRE(lease.capacity() == 1024);
+            REQUIRE(reinterpret_cast<uintptr_t>(lease.data()) % 64 == 0);
+            REQUIRE(pool.in_use() == 1);
+        }
+        REQUIRE(pool.in_use() == 0);
+        auto lease = pool.acquire(1024);
+        REQUIRE(lease.data() == first);
+        REQUIRE(pool.slab_count() == 1);
+    }
+
+    GIVEN("more leases than a slab holds") {
+        std::vector<BufferLease> leases;
+        for (int i = 0; i < 5; ++i) { leases.push_back(pool.acquire(10)); }
+        REQUIRE(pool.slab_count() == 2);
+        REQUIRE(pool.free_count() == 3);
+        leases.clear();
+        REQUIRE(pool.free_count() == 8);
+    }
+
+    GIVEN("shared leases") {
+        auto lease = pool.acquire(5);
+        std::memcpy(lease.data(), "hello", 5);
+        auto other = lease.share();
+        REQUIRE(lease.use_count() == 2);
+        REQUIRE(other.data() == lease.data());
+        lease.reset();
+        REQUIRE(pool.in_use() == 1);
+        REQUIRE(std::string_view{other.data(), other.size()} == "hello");
+        other.reset();
+        REQUIRE(pool.in_use() == 0);
+    }
+
+    GIVEN("a size larger than a block") {
+        auto lease = pool.acquire(5000);
+        REQUIRE(lease.capacity() >= 5000);
+        REQUIRE(pool.slab_count() == 0);
+        REQUIRE_THROWS_AS(lease.resize(lease.capacity() + 1), std::length_error);
+        lease.reset();
+        REQUIRE(pool.in_use() == 0);
+    }
+}
+
+SCENARIO("pooled buffers for Stream") {
+    auto& pool = get_buffer_pool();
+    asyncio::run([&]() -> Task<> {
+        int fds[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+        Stream left{fds[0]}, right{fds[1]};
+        StreamWriter writer{right};
+
+        GIVEN("echoing doesn't allocate once the pool is warm") {
+            co_await left.write("ping"sv);
+            auto data = co_await right.read<BufferLease>(200);
+            const auto slabs = pool.slab_count();
+            for (int i = 0; i < 100; ++i) {
+                co_await right.write(data);
+                data = co_await left.read<BufferLease>(200);
+                REQUIRE(std::string_view{data.data(), data.size()} == "ping");
+                co_await left.write(data);
+                data = co_await right.read<BufferLease>(200);
+            }
+            REQUIRE(pool.slab_count() == slabs);
+            data.reset();
+            REQUIRE(pool.in_use() == 0);
+        }
+
+        GIVEN("leases are handed to StreamWriter without copying") {
+            auto lease = BufferLease(4);
+            std::memcpy(lease.data(), "pong", 4);
+            writer.write(std::move(lease));
+            co_await writer.flush();
+            REQUIRE(pool.in_use() == 0);
+            auto data = co_await left.read(200);
+            REQUIRE(std::string_view{data.data(), data.size()} == "pong");
+        }
+    }());
+}
@@ -0,0 +1,162 @@
+//
+// Created on 2026/10/18.
+//
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/connection_pool.h>
+#include <asyncio/gather.h>
+#include <asyncio/runner.h>
+#include <asyncio/sleep.h>
+#include <asyncio/start_server.h>
+#include <asyncio/wait_for.h>
+
+#include <string_view>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace ASYNCIO_NS;
+using namespace std::chrono;
+
+SCENARIO("connection pool") {
+    constexpr uint16_t port = 8891;
+    constexpr std::string_view message = "ping";
+    int accepted = 0;
+    bool close_after_reply = false;
+    bool is_called = false;
+
+    auto with_server = [&](auto client) {
+        asyncio::run([&]() -> Task<> {
+            auto handle_echo = [&](Stream stream) -> Task<> {
+                ++accepted;
+                while (true) {
+                    auto data = co_await stream.read(100);
+                    if (data.empty()) { break; }
+                    co_await stream.write(data);
+                    if (close_after_reply) { break; }
+                }
+                stream.close();
+            };
+            auto server = co_await asyncio::start_server(handle_echo, "127.0.0.1", port);
+            auto srv = schedule_task(server.serve_forever());
+            co_await client();
+            is_called = true;
+            srv.cancel();
+        }());
+    };
+    auto ping = [&](ConnectionPool::Lease& lease) -> Task<> {
+        co_await lease->write(message);
+        auto data = co_await lease->read(100);
+        REQUIRE(std::string_view{data.data(), data.size()} == message);
+    };
+
+    GIVEN("a returned connection is reused") {
+        ConnectionPool pool;
+        with_server([&]() -> Task<> {
+            for (int i = 0; i < 3; ++i) {
+                auto lease = co_await pool.acquire("127.0.0.1", port);
+                co_await ping(lease);
+            }
+            REQUIRE(pool.idle_count("127.0.0.1", port) == 1);
+        });
+        REQUIRE(accepted == 1);
+        REQUIRE(pool.stats().misses == 1);
+        REQUIRE(pool.stats().hits == 2);
+    }
+
+    GIVEN("connections closed by the peer are not lent out") {
+        close_after_reply = true;
+        ConnectionPool pool;
+        with_server([&]() -> Task<> {
+            for (int i = 0; i < 2; ++i) {
+                auto lease = co_await pool.acquire("127.0.0.1", port);
+                co_await ping(lease);
+            }
+            co_await asyncio::sleep(10ms);
+            auto lease = co_await pool.acquire("127.0.0.1", port);
+            co_await ping(lease);
+        });
+        REQUIRE(accepted == 3);
+        REQUIRE(pool.stats().hits == 0);
+        REQUIRE(pool.stats().dropped == 2);
+    }
+
+    GIVEN("discarded connections are closed") {
+        ConnectionPool pool;
+        with_server([&]() -> Task<> {
+            auto lease = co_await pool.acquire("127.0.0.1", port);
+            lease.discard();
+            lease.release();
+            REQUIRE(pool.connection_count("127.0.0.1", port) == 0);
+        });
+    }
+
+    GIVEN("acquire waits when the key is at its cap") {
+        ConnectionPool pool{{ .max_per_key = 1 }};
+        with_server([&]() -> Task<> {
+            auto user = [&]() -> Task<> {
+                auto lease = co_await pool.acquire("127.0.0.1", port);
+                co_await ping(lease);
+                co_await asyncio::sleep(20ms);
+            };
+            co_await asyncio::gather(user(), user(), user());
+            REQUIRE(pool.connection_count("127.0.0.1", port) == 1);
+        });
+        REQUIRE(accepted == 1);
+        REQUIRE(pool.stats().waits >= 2);
+        REQUIRE(pool.stats().max_wait >= 40ms);
+    }
+
+    GIVEN("warm up") {
+        ConnectionPool pool{{ .max_per_key = 4, .min_idle_per_key = 2 }};
+        with_server([&]() -> Task<> {
+            co_await pool.warm_up("127.0.0.1", port);
+            REQUIRE(pool.idle_count("127.0.0.1", port) == 2);
+            {
+                auto lease = co_await pool.acquire("127.0.0.1", port);
+                co_await ping(lease);
+                // topped up in the background
+                co_await asyncio::sleep(10ms);
+                REQUIRE(pool.idle_count("127.0.0.1", port) == 2);
+            }
+            REQUIRE(pool.idle_count("127.0.0.1", port) == 3);
+        });
+        REQUIRE(accepted == 3);
+        REQUIRE(pool.stats().hit_rate() == 1.0);
+    }
+
+    REQUIRE(is_called);
+}
+
+SCENARIO("connection pool warm up, cancelled") {
+    // a listener whose accept queue is full: connecting to it hangs
+    int const listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{ .sin_family = AF_INET, .sin_port = 0, .sin_addr = { .s_addr = htonl(INADDR_LOOPBACK) } };
+    socklen_t len = sizeof(addr);
+    REQUIRE(::bind(listener, reinterpret_cast<sockaddr*>(&addr), len) == 0);
+    REQUIRE(::listen(listener, 0) == 0);
+    REQUIRE(::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+    uint16_t const port = ntohs(addr.sin_port);
+    std::vector<int> fillers;
+    for (int i = 0; i < 4; ++i) {
+        int const filler = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        ::connect(filler, reinterpret_cast<sockaddr*>(&addr), len);
+        fillers.push_back(filler);
+    }
+
+    ConnectionPool pool{{ .max_per_key = 2, .min_idle_per_key = 2 }};
+    asyncio::run([&]() -> Task<> {
+        bool timed_out = false;
+        try {
+            co_await asyncio::wait_for(pool.warm_up("127.0.0.1", port), 20ms);
+        } catch (const TimeoutError&) {
+            timed_out = true;
+        }
+        REQUIRE(timed_out);
+        // the slots of the connections being opened are given back
+        REQUIRE(pool.connection_count("127.0.0.1", port) == 0);
+    }());
+    for (int filler : fillers) { ::close(filler); }
+    ::close(listener);
+}
@@ -0,0 +1,153 @@
+//
+// Created on 2026/10/18.
+//
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/datagram.h>
+#include <asyncio/runner.h>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace ASYNCIO_NS;
+using namespace std::string_view_literals;
+
+namespace {
+Datagram datagram(std::string_view payload, uint16_t segment_size = 0) {
+    Datagram d{ .data = BufferLease(payload.size()), .segment_size = segment_size };
+    std::memcpy(d.data.data(), payload.data(), payload.size());
+    return d;
+}
+
+std::string_view payload(const Datagram& d) { return {d.data.data(), d.data.size()}; }
+
+// receives until `bytes` bytes of payload arrived, returns the datagrams
+Task<std::vector<Datagram>> receive(DatagramEndpoint& endpoint, size_t bytes) {
+    std::vector<Datagram> received;
+    size_t total = 0;
+    while (total < bytes) {
+        auto batch = co_await endpoint.recv_batch();
+        for (auto& d : batch) {
+            total += d.data.size();
+            received.push_back(std::move(d));
+        }
+    }
+    co_return received;
+}
+}
+
+SCENARIO("UDP datagram endpoints") {
+    GIVEN("a batch of datagrams, larger than the batch size") {
+        asyncio::run([]() -> Task<> {
+            auto server = co_await create_datagram_endpoint("127.0.0.1", 0);
+            DatagramOptions const options{ .batch_size = 4 };
+            auto client = co_await connect_datagram_endpoint("127.0.0.1", server.get_port(), options);
+            std::vector<Datagram> sent;
+            for (int i = 0; i < 10; ++i) { sent.push_back(datagram(std::to_string(i))); }
+            auto count = co_await client.send_batch(sent);
+            REQUIRE(count == 10);
+
+            auto received = co_await receive(server, 10);
+            REQUIRE(received.size() == 10);
+            for (int i = 0; i < 10; ++i) {
+                REQUIRE(payload(received[i]) == std::to_string(i));
+                REQUIRE(received[i].segment_size == 0);
+            }
+
+            // reply to where the datagrams came from
+            Datagram reply = datagram("pong");
+            reply.addr = received[0].addr;
+            reply.addrlen = received[0].addrlen;
+            std::vector<Datagram> replies;
+            replies.push_back(std::move(reply));
+            co_await server.send_batch(replies);
+            auto answer = co_await client.recv_batch();
+            REQUIRE(answer.size() == 1);
+            REQUIRE(payload(answer[0]) == "pong");
+            REQUIRE(answer[0].addrlen > 0);
+        }());
+    }
+
+    GIVEN("fewer datagrams than the batch size") {
+        asyncio::run([]() -> Task<> {
+            auto server = co_await create_datagram_endpoint("127.0.0.1", 0);
+            auto client = co_await connect_datagram_endpoint("127.0.0.1", server.get_port());
+            std::vector<Datagram> sent;
+            sent.push_back(datagram("one"));
+            sent.push_back(datagram("two"));
+            co_await client.send_batch(sent);
+            sent.clear();
+
+            size_t const lent = get_buffer_pool().in_use();
+            auto received = co_await receive(server, 6);
+            // only the buffers of what arrived are borrowed, not one per slot of the batch
+            REQUIRE(get_buffer_pool().in_use() - lent == received.size());
+            REQUIRE(payload(received[0]) == "one");
+            REQUIRE(payload(received.back()) == "two");
+
+            // the scratch buffer is reused for the next batch
+            sent.push_back(datagram("three"));
+            co_await client.send_batch(sent);
+            auto more = co_await server.recv_batch();
+            REQUIRE(more.size() == 1);
+            REQUIRE(payload(more[0]) == "three");
+            REQUIRE(payload(received[0]) == "one");
+        }());
+    }
+
+    GIVEN("a segmented datagram without GSO") {
+        asyncio::run([]() -> Task<> {
+            auto server = co_await create_datagram_endpoint("127.0.0.1", 0);
+            auto client = co_await connect_datagram_endpoint("127.0.0.1", server.get_port());
+            std::vector<Datagram> sent;
+            sent.push_back(datagram("aaaabbbbcc", 4));
+            sent.push_back(datagram("")); // empty datagrams are datagrams too
+            sent.push_back(datagram("dd"));
+            auto count = co_await client.send_batch(sent);
+            REQUIRE(count == 3);
+
+            std::vector<std::string> received;
+            while (received.size() < 5) {
+                auto batch = co_await server.recv_batch();
+                for (auto& d : batch) { received.emplace_back(payload(d)); }
+            }
+            REQUIRE(received == std::vector<std::string>{"aaaa", "bbbb", "cc", "", "dd"});
+        }());
+    }
+
+    GIVEN("GSO and GRO") {
+        asyncio::run([]() -> Task<> {
+            DatagramOptions const server_options{ .max_datagram_size = 64 * 1024, .gro = true };
+            DatagramOptions const client_options{ .gso = true };
+            auto server = co_await create_datagram_endpoint("127.0.0.1", 0, server_options);
+            auto client = co_await connect_datagram_endpoint("127.0.0.1", server.get_port(), client_options);
+            std::string const train = std::string(1000, 'a') + std::string(1000, 'b') + std::string(500, 'c');
+            std::vector<Datagram> sent;
+            sent.push_back(datagram(train, 1000));
+            auto count = co_await client.send_batch(sent);
+            REQUIRE(count == 1);
+
+            // the segments arrive one by one, or coalesced again, depending on what the kernel supports
+            auto received = co_await receive(server, train.size());
+            std::string joined;
+            for (auto& d : received) {
+                joined += payload(d);
+                REQUIRE((d.segment_size == 0 || d.segment_size == 1000));
+            }
+            REQUIRE(joined == train);
+        }());
+    }
+
+    GIVEN("an address that can't be bound") {
+        bool thrown = false;
+        asyncio::run([&]() -> Task<> {
+            try {
+                co_await create_datagram_endpoint("192.0.2.1", 0); // TEST-NET-1, not ours
+            } catch (const std::system_error&) {
+                thrown = true;
+            }
+        }());
+        REQUIRE(thrown);
+    }
+}
@@ -0,0 +1,93 @@
+//
+// Created on 2026/10/18.
+//
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/gather.h>
+#include <asyncio/memory_stream.h>
+#include <asyncio/runner.h>
+#include <asyncio/sleep.h>
+#include <asyncio/wait_for.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace ASYNCIO_NS;
+using namespace std::chrono;
+using namespace std::string_view_literals;
+
+SCENARIO("memory_stream_pair") {
+    GIVEN("a request and a response, then EOF") {
+        asyncio::run([]() -> Task<> {
+            auto [client, server] = memory_stream_pair();
+            co_await client.write("ping"sv);
+            REQUIRE(server.available() == 4);
+            auto ping = co_await server.read<std::string>(16);
+            REQUIRE(ping == "ping");
+            co_await server.write("pong"sv);
+            std::string buf(16, '\0');
+            auto pong = co_await client.read_in_place(std::span{buf});
+            REQUIRE(std::string_view{pong.data(), pong.size()} == "pong");
+
+            co_await client.write("bye"sv);
+            client.shutdown(SHUT_WR);
+            auto rest = co_await server.read<std::string>();
+            REQUIRE(rest == "bye");
+            // the other direction still works
+            co_await server.write("see you"sv);
+            server.close();
+            auto last = co_await client.read<std::string>();
+            REQUIRE(last == "see you");
+            auto result = co_await client.try_write("anyone there?"sv);
+            REQUIRE(result.error() == std::errc::broken_pipe);
+        }());
+    }
+
+    GIVEN("more data than fits in the buffer") {
+        asyncio::run([]() -> Task<> {
+            auto [a, b] = memory_stream_pair(1000);
+            std::string sent(100 * 1000 + 7, '\0');
+            for (size_t i = 0; i < sent.size(); ++i) { sent[i] = char(i * 7); }
+            auto writer = [&]() -> Task<> {
+                co_await a.write(sent);
+                a.close();
+            };
+            auto reader = [&]() -> Task<std::string> {
+                co_await asyncio::sleep(1ms); // let the writer fill the buffer first
+                co_return co_await b.read<std::string>();
+            };
+            auto [_, received] = co_await asyncio::gather(writer(), reader());
+            REQUIRE(received == sent);
+        }());
+    }
+
+    GIVEN("a read that timed out") {
+        asyncio::run([]() -> Task<> {
+            auto [a, b] = memory_stream_pair();
+            bool timed_out = false;
+            try {
+                co_await wait_for(b.read<std::string>(16), 10ms);
+            } catch (const TimeoutError&) {
+                timed_out = true;
+            }
+            REQUIRE(timed_out);
+            // the stream is still usable, and nothing waits on it anymore
+            co_await a.write("late"sv);
+            co_await b.wait_readable();
+            auto late = co_await b.read<std::string>(16);
+            REQUIRE(late == "late");
+        }());
+    }
+
+    GIVEN("a closed end") {
+        asyncio::run([]() -> Task<> {
+            auto [a, b] = memory_stream_pair();
+            a.close();
+            auto result = co_await a.try_write("x"sv);
+            REQUIRE(result.error() == std::errc::bad_file_descriptor);
+            std::vector<char> buf(4);
+            auto eof = co_await b.read_in_place(std::span{buf});
+            REQUIRE(eof.empty());
+        }());
+    }
+}
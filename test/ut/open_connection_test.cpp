@@ -0,0 +1,195 @@
+//
+// Created on 2026/10/18.
+//
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/open_connection.h>
+#include <asyncio/runner.h>
+#include <asyncio/sleep.h>
+#include <asyncio/start_server.h>
+
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace ASYNCIO_NS;
+using namespace std::chrono;
+
+namespace {
+AddrInfo loopback(uint16_t port) {
+    AddrInfo ai{ .family = AF_INET, .socktype = SOCK_STREAM, .addrlen = sizeof(sockaddr_in) };
+    sockaddr_in sin{ .sin_family = AF_INET, .sin_port = htons(port) };
+    inet_pton(AF_INET, "127.0.0.1", &sin.sin_addr);
+    std::memcpy(&ai.addr, &sin, sizeof(sin));
+    return ai;
+}
+
+// A listener whose accept queue is full: further SYNs are dropped, so connecting to it hangs like a blackhole.
+struct Blackhole {
+    Blackhole() {
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        auto ai = loopback(0);
+        ::bind(fd, ai.sockaddr_ptr(), ai.addrlen);
+        ::listen(fd, 0);
+        socklen_t len = sizeof(ai.addr);
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&ai.addr), &len);
+        port = get_in_port(ai.sockaddr_ptr());
+        for (int i = 0; i < 4; ++i) {
+            int c = ::socket(AF_INET, SOCK_STREAM | socket::NonBlockFlag, 0);
+            socket::set_blocking(c, false);
+            ::connect(c, ai.sockaddr_ptr(), ai.addrlen);
+            fillers.push_back(c);
+        }
+    }
+    ~Blackhole() {
+        for (int c : fillers) { ::close(c); }
+        ::close(fd);
+    }
+    int fd;
+    uint16_t port;
+    std::vector<int> fillers;
+};
+}
+
+SCENARIO("happy eyeballs connect") {
+    bool is_called = false;
+    auto with_server = [&](auto client) {
+        asyncio::run([&]() -> Task<> {
+            auto handle = [&](Stream) -> Task<> { co_return; };
+            auto server = co_await asyncio::start_server(handle, "127.0.0.1", 8890);
+            auto srv = schedule_task(server.serve_forever());
+            co_await client();
+            is_called = true;
+            srv.cancel();
+        }());
+    };
+
+    GIVEN("a blackholed first address") {
+        Blackhole blackhole;
+        with_server([&]() -> Task<> {
+            std::vector<AddrInfo> addrs{loopback(blackhole.port), loopback(8890)};
+            auto before = get_event_loop().time();
+            auto stream = co_await asyncio::open_connection(std::move(addrs),
+                                                            ConnectOptions{ .happy_eyeballs_delay = 50ms });
+            auto elapsed = get_event_loop().time() - before;
+            REQUIRE(stream.get_port(true) == 8890);
+            REQUIRE(elapsed >= 50ms);
+            REQUIRE(elapsed < 500ms);
+        });
+    }
+
+    GIVEN("a refused first address") {
+        with_server([&]() -> Task<> {
+            std::vector<AddrInfo> addrs{loopback(1), loopback(8890)};
+            auto before = get_event_loop().time();
+            auto stream = co_await asyncio::open_connection(std::move(addrs),
+                                                            ConnectOptions{ .happy_eyeballs_delay = 10s });
+            REQUIRE(stream.get_port(true) == 8890);
+            REQUIRE(get_event_loop().time() - before < 500ms);
+        });
+    }
+
+    GIVEN("no address connects") {
+        with_server([&]() -> Task<> {
+            std::vector<AddrInfo> addrs{loopback(1), loopback(2)};
+            REQUIRE_THROWS_AS(co_await asyncio::open_connection(std::move(addrs)), std::system_error);
+        });
+    }
+
+    GIVEN("no address connects, without exceptions") {
+        with_server([&]() -> Task<> {
+            std::vector<AddrInfo> addrs{loopback(1), loopback(2)};
+            auto stream = co_await asyncio::try_open_connection(std::move(addrs));
+            REQUIRE_FALSE(stream.has_value());
+            REQUIRE(stream.error() == std::errc::connection_refused); // the last attempt's error
+            auto connected = co_await asyncio::try_open_connection("127.0.0.1", 8890);
+            REQUIRE(connected.has_value());
+            REQUIRE(connected->get_port(true) == 8890);
+        });
+    }
+
+    REQUIRE(is_called);
+}
+
+SCENARIO("open_connection binds the source address") {
+    std::vector<std::string> local_addrs;
+    asyncio::run([&]() -> Task<> {
+        auto handle = [&](Stream) -> Task<> { co_return; };
+        auto server = co_await asyncio::start_server(handle, "127.0.0.1", 8890);
+        auto srv = schedule_task(server.serve_forever());
+        auto local_addr = [](const Stream& stream) {
+            char addr[INET_ADDRSTRLEN] {};
+            auto sin = std::get<sockaddr_in>(stream.get_sockaddr());
+            return std::string{inet_ntop(AF_INET, &sin.sin_addr, addr, sizeof(addr))};
+        };
+
+        GIVEN("round-robin over the source addresses") {
+            ConnectOptions options{ .local_addrs = {"127.0.0.2", "127.0.0.3"} };
+            for (int i = 0; i < 4; ++i) {
+                auto stream = co_await asyncio::open_connection("127.0.0.1", 8890, options);
+                local_addrs.push_back(local_addr(stream));
+            }
+            REQUIRE(local_addrs[0] != local_addrs[1]);
+            REQUIRE(local_addrs[0] == local_addrs[2]);
+            REQUIRE(local_addrs[1] == local_addrs[3]);
+        }
+
+        GIVEN("a source port range") {
+            ConnectOptions options{ .local_addrs = {"127.0.0.2"}, .local_port_range = {40100, 40109} };
+            for (int i = 0; i < 3; ++i) {
+                auto stream = co_await asyncio::open_connection("127.0.0.1", 8890, options);
+                REQUIRE(local_addr(stream) == "127.0.0.2");
+                REQUIRE(stream.get_port() >= 40100);
+                REQUIRE(stream.get_port() <= 40109);
+            }
+        }
+
+        GIVEN("no source address of the destination's family") {
+            ConnectOptions options{ .local_addrs = {"::1"} };
+            REQUIRE_THROWS_AS(co_await asyncio::open_connection("127.0.0.1", 8890, options), std::system_error);
+        }
+        srv.cancel();
+    }());
+}
+
+SCENARIO("unix domain socket connections") {
+    auto echo_over = [](std::string path) {
+        asyncio::run([&]() -> Task<> {
+            auto handle = [](Stream stream) -> Task<> {
+                auto data = co_await stream.read<std::string>(64);
+                co_await stream.write(data);
+            };
+            auto server = co_await asyncio::start_unix_server(handle, path);
+            auto srv = schedule_task(server.serve_forever());
+            auto stream = co_await asyncio::open_unix_connection(path);
+            co_await stream.write(std::string_view{"over AF_UNIX"});
+            auto echoed = co_await stream.read<std::string>(64);
+            REQUIRE(echoed == "over AF_UNIX");
+            REQUIRE(stream.get_sock_info(true).ss_family == AF_UNIX);
+            srv.cancel();
+        }());
+    };
+
+    GIVEN("a socket file, left over from an earlier server") {
+        std::string const path = "/tmp/asyncio_ut_" + std::to_string(::getpid()) + ".sock";
+        echo_over(path);
+        echo_over(path);
+        ::unlink(path.c_str());
+    }
+
+    GIVEN("an abstract socket name") {
+        echo_over(std::string{"\0asyncio_ut_", 12} + std::to_string(::getpid()));
+    }
+
+    GIVEN("nothing listening") {
+        asyncio::run([&]() -> Task<> {
+            auto stream = co_await asyncio::try_open_unix_connection("/tmp/asyncio_ut_nothing_here.sock");
+            REQUIRE(stream.error() == std::errc::no_such_file_or_directory);
+            auto too_long = co_await asyncio::try_open_unix_connection(std::string(200, 'x'));
+            REQUIRE(too_long.error() == std::errc::filename_too_long);
+        }());
+    }
+}
@@ -0,0 +1,101 @@
+//
+// Created on 2026/10/18.
+//
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/gather.h>
+#include <asyncio/relay.h>
+#include <asyncio/runner.h>
+#include <asyncio/sleep.h>
+
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <sys/socket.h>
+
+using namespace ASYNCIO_NS;
+using namespace std::chrono;
+using namespace std::string_view_literals;
+
+namespace {
+// client <-> proxy_client ~ relay ~ proxy_server <-> server; runs `body(client, server)` alongside the relay
+template<typename Body>
+RelayResult with_proxy(Body body) {
+    RelayResult result;
+    asyncio::run([&]() -> Task<> {
+        int left[2], right[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, left) == 0);
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, right) == 0);
+        Stream client{left[0]}, proxy_client{left[1]}, proxy_server{right[0]}, server{right[1]};
+        auto proxy = [&]() -> Task<> { result = co_await relay(proxy_client, proxy_server); };
+        co_await asyncio::gather(proxy(), body(client, server));
+    }());
+    return result;
+}
+}
+
+SCENARIO("relay between two streams") {
+    GIVEN("a request and a response, with half-closes") {
+        auto result = with_proxy([](Stream& client, Stream& server) -> Task<> {
+            co_await client.write("request"sv);
+            client.shutdown(SHUT_WR);
+            auto request = co_await server.read<std::string>();
+            REQUIRE(request == "request");
+            // the client's half-close doesn't stop the response
+            co_await server.write("response"sv);
+            server.shutdown(SHUT_WR);
+            auto response = co_await client.read<std::string>();
+            REQUIRE(response == "response");
+        });
+        REQUIRE(result.a_to_b == 7);
+        REQUIRE(result.b_to_a == 8);
+    }
+
+    GIVEN("a slow receiver") {
+        const std::string sent(2 * 1024 * 1024, 'x');
+        size_t received = 0;
+        auto result = with_proxy([&](Stream& client, Stream& server) -> Task<> {
+            auto send = [&]() -> Task<> {
+                co_await client.write(sent);
+                client.shutdown(SHUT_WR);
+            };
+            auto receive = [&]() -> Task<> {
+                std::vector<char> buf(16 * 1024);
+                while (true) {
+                    co_await asyncio::sleep(1ms);
+                    auto data = co_await server.read_in_place(std::span{buf});
+                    if (data.empty()) { break; }
+                    received += data.size();
+                }
+                server.shutdown(SHUT_WR);
+            };
+            co_await asyncio::gather(send(), receive());
+        });
+        REQUIRE(received == sent.size());
+        REQUIRE(result.a_to_b == sent.size());
+        REQUIRE(result.b_to_a == 0);
+    }
+
+    GIVEN("a receiver that goes away mid-stream") {
+        std::error_code error;
+        try {
+            with_proxy([](Stream& client, Stream& server) -> Task<> {
+                auto send = [&]() -> Task<> {
+                    co_await client.write(std::string(2 * 1024 * 1024, 'x'));
+                };
+                auto receive = [&]() -> Task<> {
+                    auto data = co_await server.read(1024);
+                    REQUIRE(! data.empty());
+                    server.close();
+                };
+                co_await asyncio::gather(send(), receive());
+            });
+        } catch (const std::system_error& e) {
+            error = e.code();
+        }
+        // rather than SIGPIPE killing the process; the unread data the server dropped may make it a reset instead
+        bool const peer_gone = error == std::errc::broken_pipe || error == std::errc::connection_reset;
+        REQUIRE(peer_gone);
+    }
+}
@@ -0,0 +1,221 @@
+//
+// Created on 2026/10/18.
+//
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/gather.h>
+#include <asyncio/open_connection.h>
+#include <asyncio/resolver.h>
+#include <asyncio/runner.h>
+#include <asyncio/sleep.h>
+#include <asyncio/start_server.h>
+#include <asyncio/stream.h>
+
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <signal.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+using namespace ASYNCIO_NS;
+using namespace std::chrono;
+
+namespace {
+// stand-in for a DNS server: knows a single name, and takes its time answering
+struct SlowLookup {
+    milliseconds delay;
+    std::atomic<int>& calls;
+    int operator()(const std::string& host, const std::string& service, const addrinfo& hints,
+                   std::vector<AddrInfo>& result) const {
+        ++calls;
+        std::this_thread::sleep_for(delay);
+        if (host != "slow.test") { return EAI_NONAME; }
+        auto& ai = result.emplace_back();
+        sockaddr_in sin{ .sin_family = AF_INET, .sin_port = htons(uint16_t(std::stoi(service))) };
+        inet_pton(AF_INET, "127.0.0.1", &sin.sin_addr);
+        std::memcpy(&ai.addr, &sin, sizeof(sin));
+        ai.family = AF_INET;
+        ai.socktype = hints.ai_socktype;
+        ai.addrlen = sizeof(sin);
+        return 0;
+    }
+};
+}
+
+SCENARIO("resolver doesn't block the event loop") {
+    std::atomic<int> calls{0};
+    Resolver resolver{2, SlowLookup{100ms, calls}};
+
+    GIVEN("a slow lookup and a ticking coroutine") {
+        int ticks = 0;
+        asyncio::run([&]() -> Task<> {
+            auto ticker = [&]() -> Task<> {
+                for (int i = 0; i < 5; ++i) {
+                    co_await asyncio::sleep(10ms);
+                    ++ticks;
+                }
+            };
+            auto&& [addrs, _] = co_await asyncio::gather(resolver.resolve("slow.test", 80), ticker());
+            REQUIRE(addrs.size() == 1);
+            REQUIRE(addrs[0].family == AF_INET);
+            REQUIRE(ticks == 5);
+        }());
+        REQUIRE(calls == 1);
+        REQUIRE(resolver.pending() == 0);
+    }
+
+    GIVEN("lookups run in parallel on the worker threads") {
+        auto before = get_event_loop().time();
+        asyncio::run([&]() -> Task<> {
+            co_await asyncio::gather(resolver.resolve("slow.test", 80), resolver.resolve("slow.test", 81));
+        }());
+        REQUIRE(get_event_loop().time() - before < 200ms);
+    }
+
+    GIVEN("numeric hosts are resolved inline") {
+        asyncio::run([&]() -> Task<> {
+            auto addrs = co_await resolver.resolve("127.0.0.1", 80);
+            REQUIRE(addrs.size() == 1);
+        }());
+        REQUIRE(calls == 0);
+    }
+
+    GIVEN("unknown names throw") {
+        REQUIRE_THROWS_AS(asyncio::run(resolver.resolve("nx.test", 80)), std::system_error);
+    }
+
+    GIVEN("try_resolve returns errors instead") {
+        auto unknown = asyncio::run(resolver.try_resolve("nx.test", 80));
+        REQUIRE(unknown.error() == std::errc::address_not_available);
+        auto known = asyncio::run(resolver.try_resolve("slow.test", 80));
+        REQUIRE(known.has_value());
+        REQUIRE(known->size() == 1);
+    }
+
+    GIVEN("an abandoned lookup") {
+        asyncio::run([&]() -> Task<> {
+            auto task = schedule_task(resolver.resolve("slow.test", 80));
+            co_await asyncio::sleep(10ms);
+            task.cancel();
+        }());
+        REQUIRE(resolver.pending() == 0);
+    }
+
+    GIVEN("signals are for the loop, not for the workers") {
+        std::atomic<bool> worker_blocks{false};
+        Resolver blocking{1, [&](const std::string&, const std::string&, const addrinfo&, std::vector<AddrInfo>&) {
+            sigset_t mask;
+            ::pthread_sigmask(SIG_SETMASK, nullptr, &mask);
+            worker_blocks = sigismember(&mask, SIGTERM) && sigismember(&mask, SIGCHLD);
+            return EAI_NONAME;
+        }};
+        auto result = asyncio::run(blocking.try_resolve("nx.test", 80));
+        REQUIRE_FALSE(result.has_value());
+        REQUIRE(worker_blocks);
+        // and the thread that started them has its own mask back
+        sigset_t mask;
+        ::pthread_sigmask(SIG_SETMASK, nullptr, &mask);
+        REQUIRE_FALSE(sigismember(&mask, SIGTERM));
+    }
+}
+
+SCENARIO("resolver cache") {
+    std::atomic<int> calls{0};
+    Resolver resolver{2, SlowLookup{20ms, calls}};
+
+    GIVEN("repeated lookups are answered from the cache") {
+        asyncio::run([&]() -> Task<> {
+            co_await resolver.resolve("slow.test", 80);
+            auto addrs = co_await resolver.resolve("slow.test", 80);
+            REQUIRE(addrs.size() == 1);
+        }());
+        REQUIRE(calls == 1);
+        REQUIRE(resolver.cache_stats().misses == 1);
+        REQUIRE(resolver.cache_stats().hits == 1);
+    }
+
+    GIVEN("one lookup per name, whatever the port") {
+        asyncio::run([&]() -> Task<> {
+            auto http = co_await resolver.resolve("slow.test", 80);
+            auto https = co_await resolver.resolve("slow.test", 443);
+            REQUIRE(get_in_port(http[0].sockaddr_ptr()) == 80);
+            REQUIRE(get_in_port(https[0].sockaddr_ptr()) == 443);
+        }());
+        REQUIRE(calls == 1);
+        REQUIRE(resolver.cache_size() == 1);
+    }
+
+    GIVEN("a full cache drops the answers that expire first") {
+        resolver.set_cache_size(2);
+        asyncio::run(resolver.resolve("slow.test", 80)); // cached for cache_ttl
+        REQUIRE_THROWS_AS(asyncio::run(resolver.resolve("nx1.test", 80)), std::system_error); // for negative_ttl
+        REQUIRE_THROWS_AS(asyncio::run(resolver.resolve("nx2.test", 80)), std::system_error); // evicts nx1.test
+        REQUIRE(resolver.cache_size() == 2);
+        REQUIRE(calls == 3);
+        asyncio::run(resolver.resolve("slow.test", 80));
+        REQUIRE_THROWS_AS(asyncio::run(resolver.resolve("nx2.test", 80)), std::system_error);
+        REQUIRE(calls == 3);
+        REQUIRE_THROWS_AS(asyncio::run(resolver.resolve("nx1.test", 80)), std::system_error);
+        REQUIRE(calls == 4);
+    }
+
+    GIVEN("concurrent lookups of the same name are coalesced") {
+        asyncio::run([&]() -> Task<> {
+            auto&& [a, b, c] = co_await asyncio::gather(resolver.resolve("slow.test", 80),
+                                                        resolver.resolve("slow.test", 80),
+                                                        resolver.resolve("slow.test", 8080));
+            REQUIRE(a.size() == 1);
+            REQUIRE(get_in_port(c[0].sockaddr_ptr()) == 8080);
+            REQUIRE(b.size() == 1);
+            REQUIRE(c.size() == 1);
+        }());
+        REQUIRE(calls == 1);
+        REQUIRE(resolver.cache_stats().coalesced == 2);
+    }
+
+    GIVEN("unknown names are cached briefly") {
+        resolver.set_cache_ttl(1s, 30ms);
+        REQUIRE_THROWS_AS(asyncio::run(resolver.resolve("nx.test", 80)), std::system_error);
+        REQUIRE_THROWS_AS(asyncio::run(resolver.resolve("nx.test", 80)), std::system_error);
+        REQUIRE(calls == 1);
+        REQUIRE(resolver.cache_stats().negative_hits == 1);
+        asyncio::run(asyncio::sleep(40ms));
+        REQUIRE_THROWS_AS(asyncio::run(resolver.resolve("nx.test", 80)), std::system_error);
+        REQUIRE(calls == 2);
+    }
+
+    GIVEN("flush drops cached answers") {
+        asyncio::run(resolver.resolve("slow.test", 80));
+        REQUIRE(resolver.cache_size() == 1);
+        resolver.flush_cache("other.test");
+        REQUIRE(resolver.cache_size() == 1);
+        resolver.flush_cache("slow.test");
+        REQUIRE(resolver.cache_size() == 0);
+        asyncio::run(resolver.resolve("slow.test", 80));
+        REQUIRE(calls == 2);
+    }
+
+    GIVEN("caching disabled") {
+        resolver.set_cache_ttl(0ms, 0ms);
+        asyncio::run(resolver.resolve("slow.test", 80));
+        asyncio::run(resolver.resolve("slow.test", 80));
+        REQUIRE(calls == 2);
+        REQUIRE(resolver.cache_size() == 0);
+    }
+}
+
+SCENARIO("open_connection & start_server resolve asynchronously") {
+    bool is_called = false;
+    asyncio::run([&]() -> Task<> {
+        auto handle = [&](Stream) -> Task<> { co_return; };
+        auto server = co_await asyncio::start_server(handle, "localhost", 8889);
+        auto srv = schedule_task(server.serve_forever());
+        auto stream = co_await asyncio::open_connection("localhost", 8889);
+        REQUIRE(stream.get_port(true) == 8889);
+        is_called = true;
+        srv.cancel();
+    }());
+    REQUIRE(is_called);
+}
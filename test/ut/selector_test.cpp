@@ -3,7 +3,18 @@
 //
 #include <catch2/catch_test_macros.hpp>
 #include <asyncio/event_loop.h>
+#include <asyncio/gather.h>
+#include <asyncio/runner.h>
+#include <asyncio/schedule_task.h>
 #include <asyncio/selector/selector.h>
+#include <asyncio/sleep.h>
+
+#include <string>
+#include <system_error>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 using namespace ASYNCIO_NS;
 using namespace std::chrono;
@@ -16,3 +27,193 @@ SCENARIO("test selector wait") {
     auto after_wait = loop.time();
     REQUIRE(after_wait - before_wait >= 300ms);
 }
+
+SCENARIO("fd watchers") {
+    int fds[2];
+    REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+    auto& loop = get_event_loop();
+
+    GIVEN("a reader and a writer on the same fd") {
+        std::string received;
+        size_t writable = 0;
+        loop.add_writer(fds[0], [&] {
+            ++writable;
+            loop.remove_writer(fds[0]); // one-shot
+        });
+        loop.add_reader(fds[0], [&] {
+            char buf[16];
+            ssize_t n = ::read(fds[0], buf, sizeof(buf));
+            if (n > 0) { received.append(buf, size_t(n)); }
+            if (received.ends_with('.')) { loop.remove_reader(fds[0]); }
+        });
+        // replaced: only the latest callback is called
+        size_t replaced = 0;
+        loop.add_reader(fds[1], [&] { ++replaced; });
+        loop.add_reader(fds[1], [&] { loop.remove_reader(fds[1]); });
+        REQUIRE(::write(fds[0], "x", 1) == 1);
+        asyncio::run([&]() -> Task<> {
+            REQUIRE(::write(fds[1], "hello", 5) == 5);
+            co_await asyncio::sleep(1ms);
+            REQUIRE(::write(fds[1], " world.", 7) == 7);
+        }());
+        REQUIRE(received == "hello world.");
+        REQUIRE(writable == 1);
+        REQUIRE(replaced == 0);
+        REQUIRE_FALSE(loop.remove_reader(fds[0]));
+    }
+
+    GIVEN("a callback removing another that is ready in the same tick") {
+        size_t calls = 0;
+        REQUIRE(::write(fds[0], "x", 1) == 1);
+        REQUIRE(::write(fds[1], "y", 1) == 1);
+        loop.add_reader(fds[0], [&] { ++calls; loop.remove_reader(fds[0]); loop.remove_reader(fds[1]); });
+        loop.add_reader(fds[1], [&] { ++calls; loop.remove_reader(fds[0]); loop.remove_reader(fds[1]); });
+        asyncio::run([]() -> Task<> { co_return; }());
+        REQUIRE(calls == 1);
+    }
+
+    GIVEN("awaiting a foreign fd") {
+        asyncio::run([&]() -> Task<> {
+            co_await loop.wait_writable(fds[0]);
+            auto writer = [&]() -> Task<> {
+                co_await asyncio::sleep(1ms);
+                REQUIRE(::write(fds[0], "x", 1) == 1);
+            };
+            auto reader = [&]() -> Task<> {
+                co_await loop.wait_readable(fds[1]);
+                char c{};
+                REQUIRE(::read(fds[1], &c, 1) == 1);
+                REQUIRE(c == 'x');
+            };
+            co_await asyncio::gather(reader(), writer());
+        }());
+    }
+
+    GIVEN("fds that can't be watched") {
+        auto error_of = [&](int fd) {
+            try {
+                loop.add_reader(fd, [] {});
+            } catch (const std::system_error& e) {
+                return e.code();
+            }
+            return std::error_code{};
+        };
+        int const closed = ::dup(fds[0]);
+        ::close(closed);
+        REQUIRE(error_of(closed) == std::errc::bad_file_descriptor);
+        REQUIRE_FALSE(loop.remove_reader(closed));
+
+        // taken by a coroutine waiting on the fd
+        asyncio::run([&]() -> Task<> {
+            auto waiting = [&]() -> Task<> { co_await loop.wait_readable(fds[1]); };
+            auto watching = [&]() -> Task<> {
+                co_await asyncio::sleep(1ms);
+                REQUIRE(error_of(fds[1]) == std::errc::device_or_resource_busy);
+                REQUIRE(::write(fds[0], "x", 1) == 1); // the wait still gets its event
+            };
+            co_await asyncio::gather(waiting(), watching());
+        }());
+        REQUIRE(error_of(fds[1]) == std::error_code{}); // free again
+        REQUIRE(loop.remove_reader(fds[1]));
+    }
+
+    GIVEN("waits that can't be armed") {
+        auto wait_error = [&](int fd) -> Task<std::error_code> {
+            try {
+                co_await loop.wait_readable(fd);
+            } catch (const std::system_error& e) {
+                co_return e.code();
+            }
+            co_return std::error_code{};
+        };
+        bool done = false; // rather than left suspended, with nothing registered to keep run() going
+        asyncio::run([&]() -> Task<> {
+            int const closed = ::dup(fds[0]);
+            ::close(closed);
+            auto error = co_await wait_error(closed);
+            REQUIRE(error == std::errc::bad_file_descriptor);
+
+            // taken by a watcher, which keeps its events
+            size_t calls = 0;
+            loop.add_reader(fds[1], [&] { ++calls; loop.remove_reader(fds[1]); });
+            error = co_await wait_error(fds[1]);
+            REQUIRE(error == std::errc::device_or_resource_busy);
+            REQUIRE(::write(fds[0], "x", 1) == 1);
+            co_await asyncio::sleep(1ms);
+            REQUIRE(calls == 1);
+
+            // taken by another wait, which keeps its events
+            char c{};
+            REQUIRE(::read(fds[1], &c, 1) == 1);
+            auto waiting = schedule_task(wait_error(fds[1]));
+            co_await asyncio::sleep(1ms);
+            error = co_await wait_error(fds[1]);
+            REQUIRE(error == std::errc::device_or_resource_busy);
+            REQUIRE(::write(fds[0], "y", 1) == 1);
+            error = co_await waiting;
+            REQUIRE(error == std::error_code{});
+            done = true;
+        }());
+        REQUIRE(done);
+    }
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+SCENARIO("embedding the loop in another poller") {
+    auto& loop = get_event_loop();
+
+    GIVEN("nothing to do") {
+        REQUIRE(loop.next_timeout() == std::nullopt);
+        REQUIRE(loop.poll() == 0);
+    }
+
+    GIVEN("a coroutine sleeping in between ticks of the outer loop") {
+        bool done = false;
+        auto task = schedule_task([&]() -> Task<> {
+            co_await asyncio::sleep(20ms);
+            done = true;
+        }());
+        REQUIRE(loop.next_timeout() == 0ms); // ready to start
+        REQUIRE(loop.poll() == 1);
+        auto timeout = loop.next_timeout();
+        REQUIRE(timeout.has_value());
+        REQUIRE(*timeout <= 20ms);
+        REQUIRE(loop.poll() == 0); // doesn't block
+        // an outer poller sleeping until the timer is due
+        pollfd pfd{ .fd = loop.get_fd(), .events = POLLIN };
+        ::poll(&pfd, 1, int(timeout->count()) + 1);
+        while (! done) { loop.poll(loop.next_timeout().value_or(0ms)); }
+        REQUIRE(task.done());
+    }
+
+    GIVEN("an fd becoming ready") {
+        int fds[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+        size_t calls = 0;
+        loop.add_reader(fds[1], [&] { ++calls; loop.remove_reader(fds[1]); });
+        pollfd pfd{ .fd = loop.get_fd(), .events = POLLIN };
+        REQUIRE(::poll(&pfd, 1, 0) == 0);
+        REQUIRE(::write(fds[0], "x", 1) == 1);
+        REQUIRE(::poll(&pfd, 1, 1000) == 1); // the loop's fd tells the outer poller
+        REQUIRE(loop.poll() == 1);
+        REQUIRE(calls == 1);
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    GIVEN("a time slice") {
+        size_t ticks = 0;
+        auto task = schedule_task([&]() -> Task<> {
+            while (true) {
+                co_await asyncio::sleep(5ms);
+                ++ticks;
+            }
+        }());
+        auto before = loop.time();
+        loop.run_for(50ms);
+        REQUIRE(loop.time() - before >= 50ms);
+        REQUIRE(ticks > 0);
+        task.cancel();
+    }
+}
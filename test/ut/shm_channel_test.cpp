@@ -0,0 +1,196 @@
+//
+// Created on 2026/10/18.
+//
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/gather.h>
+#include <asyncio/runner.h>
+#include <asyncio/shm_channel.h>
+#include <asyncio/sleep.h>
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ASYNCIO_NS;
+using namespace std::chrono;
+using namespace std::string_view_literals;
+
+namespace {
+// both ends of a new channel, in this process
+std::pair<ShmChannel, ShmChannel> channel_pair(size_t capacity = ShmChannel::default_capacity) {
+    auto creator = ShmChannel::create(capacity);
+    auto fds = creator.peer_fds();
+    auto attached = ShmChannel::attach(fds);
+    return {std::move(creator), std::move(attached)};
+}
+}
+
+SCENARIO("ShmChannel") {
+    GIVEN("a message each way, then EOF") {
+        asyncio::run([]() -> Task<> {
+            auto [a, b] = channel_pair();
+            REQUIRE(a.capacity() >= ShmChannel::default_capacity);
+            REQUIRE(a.capacity() == b.capacity());
+            co_await a.write("ping"sv);
+            auto ping = co_await b.read<std::string>(16);
+            REQUIRE(ping == "ping");
+            co_await b.write("pong"sv);
+            std::string buf(16, '\0');
+            auto pong = co_await a.read_in_place(std::span{buf});
+            REQUIRE(std::string_view{pong.data(), pong.size()} == "pong");
+
+            co_await a.write("last words"sv);
+            a.close();
+            auto rest = co_await b.read<std::string>();
+            REQUIRE(rest == "last words");
+            bool thrown = false;
+            try {
+                co_await b.write("anyone there?"sv);
+            } catch (const std::system_error& e) {
+                thrown = e.code() == std::errc::broken_pipe;
+            }
+            REQUIRE(thrown);
+        }());
+    }
+
+    GIVEN("more data than fits in the ring") {
+        asyncio::run([]() -> Task<> {
+            auto [a, b] = channel_pair(4096);
+            std::string sent(1024 * 1024, '\0');
+            for (size_t i = 0; i < sent.size(); ++i) { sent[i] = char(i * 7); }
+            auto writer = [&]() -> Task<> {
+                co_await a.write(sent);
+                a.close();
+            };
+            auto reader = [&]() -> Task<std::string> {
+                co_await asyncio::sleep(1ms); // let the writer fill the ring first
+                co_return co_await b.read<std::string>();
+            };
+            auto [_, received] = co_await asyncio::gather(writer(), reader());
+            REQUIRE(received == sent);
+            REQUIRE(a.stats().waits > 0);
+            REQUIRE(b.stats().doorbells > 0);
+        }());
+    }
+
+    GIVEN("a reader that isn't waiting") {
+        asyncio::run([]() -> Task<> {
+            auto [a, b] = channel_pair();
+            for (int i = 0; i < 100; ++i) { co_await a.write("x"sv); }
+            REQUIRE(a.stats().doorbells == 0);
+            auto data = co_await b.read<std::string>(100, true);
+            REQUIRE(data.size() == 100);
+            REQUIRE(b.stats().waits == 0);
+
+            // a waiting reader gets exactly one doorbell
+            auto reader = [&]() -> Task<> { auto more = co_await b.read<std::string>(1); };
+            auto writer = [&]() -> Task<> {
+                co_await asyncio::sleep(1ms);
+                co_await a.write("y"sv);
+            };
+            co_await asyncio::gather(reader(), writer());
+            REQUIRE(a.stats().doorbells == 1);
+        }());
+    }
+
+    GIVEN("a peer that scribbles over the positions in the ring") {
+        auto creator = ShmChannel::create(4096);
+        auto fds = creator.peer_fds();
+        // the creator's ring comes first: `head` at its start, `tail` on the next cache line
+        void* mapping = ::mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+        REQUIRE(mapping != MAP_FAILED);
+        auto positions = static_cast<std::atomic<uint64_t>*>(mapping);
+        auto attached = ShmChannel::attach(fds);
+        asyncio::run([&]() -> Task<> {
+            auto failure = [](Task<> io) -> Task<std::error_code> {
+                try {
+                    co_await std::move(io);
+                } catch (const std::system_error& e) {
+                    co_return e.code();
+                }
+                co_return std::error_code{};
+            };
+            positions[0].store(uint64_t(1) << 40); // more written than fits in the ring
+            auto read = [&]() -> Task<> { auto data = co_await attached.read<std::string>(16); };
+            auto read_error = co_await failure(read());
+            REQUIRE(read_error == std::errc::protocol_error);
+
+            positions[0].store(0);
+            positions[8].store(5); // more read than written
+            auto write = [&]() -> Task<> { co_await creator.write("x"sv); };
+            auto write_error = co_await failure(write());
+            REQUIRE(write_error == std::errc::protocol_error);
+        }());
+        ::munmap(mapping, 4096);
+    }
+
+    GIVEN("a peer that exits without closing its end") {
+        auto creator = ShmChannel::create(4096);
+        auto fds = creator.peer_fds();
+        pid_t const child = ::fork();
+        if (child == 0) {
+            auto attached = ShmChannel::attach(fds);
+            ::_exit(0); // no destructors: as if it crashed
+        }
+        for (int fd : fds) { ::close(fd); }
+        asyncio::run([&]() -> Task<> {
+            auto data = co_await creator.read<std::string>(16);
+            REQUIRE(data.empty()); // EOF
+            bool reset = false;
+            try {
+                co_await creator.write(std::string(8192, 'x')); // more than fits, so that it has to wait for room
+            } catch (const std::system_error& e) {
+                reset = e.code() == std::errc::connection_reset;
+            }
+            REQUIRE(reset);
+            creator.close(); // its doorbells stay registered with the loop until then
+        }());
+        int status = 0;
+        REQUIRE(::waitpid(child, &status, 0) == child);
+    }
+
+    GIVEN("another process, attached through fds sent over a unix socket") {
+        int sockets[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets) == 0);
+        pid_t const child = ::fork();
+        if (child == 0) {
+            ::close(sockets[0]);
+            bool ok = false;
+            // on a new thread, for an EventLoop of its own: the epoll instance of this thread's is shared with the parent
+            std::thread{[&] {
+                asyncio::run([&]() -> Task<> {
+                    Stream control{sockets[1]};
+                    auto fds = co_await control.recv_fds();
+                    auto channel = ShmChannel::attach(fds);
+                    auto request = co_await channel.read<std::string>(64);
+                    std::string const response = "re: " + request;
+                    co_await channel.write(response);
+                    ok = request == "request";
+                }());
+            }}.join();
+            ::_exit(ok ? 0 : 1);
+        }
+        ::close(sockets[1]);
+        asyncio::run([&]() -> Task<> {
+            Stream control{sockets[0]};
+            auto channel = ShmChannel::create();
+            auto fds = channel.peer_fds();
+            co_await control.send_fds(fds);
+            for (int fd : fds) { ::close(fd); }
+            co_await channel.write("request"sv);
+            auto response = co_await channel.read<std::string>(64);
+            REQUIRE(response == "re: request");
+        }());
+        int status = 0;
+        REQUIRE(::waitpid(child, &status, 0) == child);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+    }
+}
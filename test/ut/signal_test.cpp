@@ -0,0 +1,90 @@
+//
+// Created on 2026/10/18.
+//
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/gather.h>
+#include <asyncio/runner.h>
+#include <asyncio/signal.h>
+#include <asyncio/sleep.h>
+
+#include <atomic>
+#include <system_error>
+#include <thread>
+
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+using namespace ASYNCIO_NS;
+using namespace std::chrono;
+
+SCENARIO("signals") {
+    GIVEN("coroutines waiting for a signal") {
+        asyncio::run([]() -> Task<> {
+            size_t woken = 0;
+            auto waiter = [&]() -> Task<> {
+                co_await wait_signal(SIGUSR1);
+                ++woken;
+            };
+            auto sender = [&]() -> Task<> {
+                co_await asyncio::sleep(1ms);
+                ::pthread_kill(::pthread_self(), SIGUSR1);
+            };
+            co_await asyncio::gather(waiter(), waiter(), sender());
+            REQUIRE(woken == 2);
+        }());
+    }
+
+    GIVEN("a signal that came in while no one waited") {
+        add_signal_handler(SIGUSR1, [] {}); // claims, and so blocks, it
+        remove_signal_handler(SIGUSR1);
+        ::pthread_kill(::pthread_self(), SIGUSR1); // stays pending
+        asyncio::run([]() -> Task<> { co_await wait_signal(SIGUSR1); }());
+    }
+
+    GIVEN("a handler") {
+        size_t calls = 0;
+        asyncio::run([&]() -> Task<> {
+            add_signal_handler(SIGUSR1, [&] {
+                if (++calls == 3) { remove_signal_handler(SIGUSR1); }
+            });
+            for (int i = 0; i < 3; ++i) {
+                ::pthread_kill(::pthread_self(), SIGUSR1);
+                co_await asyncio::sleep(1ms);
+            }
+        }());
+        REQUIRE(calls == 3);
+        REQUIRE_FALSE(remove_signal_handler(SIGUSR1));
+    }
+
+    GIVEN("another loop") {
+        // delivered to the loop that claimed it: the others block it too
+        sigset_t set;
+        sigemptyset(&set);
+        sigaddset(&set, SIGUSR2);
+        pthread_sigmask(SIG_BLOCK, &set, nullptr);
+        bool received = false;
+        std::atomic<bool> claimed = false;
+        std::thread other{[&] {
+            add_signal_handler(SIGUSR2, [&] {
+                received = true;
+                remove_signal_handler(SIGUSR2);
+            });
+            claimed = true;
+            asyncio::run([]() -> Task<> { co_return; }());
+        }};
+        while (! claimed) { std::this_thread::sleep_for(1ms); }
+        bool busy = false;
+        asyncio::run([&]() -> Task<> {
+            try {
+                co_await wait_signal(SIGUSR2);
+            } catch (const std::system_error& e) {
+                busy = e.code() == std::errc::device_or_resource_busy;
+            }
+            ::kill(::getpid(), SIGUSR2); // to the process: pending until the loop that claimed it reads it
+        }());
+        other.join();
+        REQUIRE(busy);
+        REQUIRE(received);
+    }
+}
@@ -0,0 +1,118 @@
+//
+// Created on 2026/10/18.
+//
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/runner.h>
+#include <asyncio/stream_reader.h>
+
+#include <string>
+#include <string_view>
+
+#include <sys/socket.h>
+
+using namespace ASYNCIO_NS;
+using namespace std::string_view_literals;
+
+namespace {
+std::string_view view(std::span<const char> s) { return {s.data(), s.size()}; }
+
+// runs `body(reading, writing)` on the two ends of a socket pair
+template<typename Body>
+void with_socketpair(Body body) {
+    asyncio::run([&]() -> Task<> {
+        int fds[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+        Stream reading{fds[0]}, writing{fds[1]};
+        co_await body(reading, writing);
+    }());
+}
+}
+
+SCENARIO("buffered stream reader") {
+    GIVEN("many small frames in a single read") {
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            co_await writing.write("a\nbb\r\nccc\n"sv);
+            StreamReader reader{reading};
+            auto line = co_await reader.readline();
+            REQUIRE(view(line) == "a\n");
+            // everything else came in with the first read
+            REQUIRE(view(reader.buffered()) == "bb\r\nccc\n");
+            line = co_await reader.readuntil("\r\n");
+            REQUIRE(view(line) == "bb\r\n");
+            line = co_await reader.readline();
+            REQUIRE(view(line) == "ccc\n");
+            REQUIRE(reader.buffered().empty());
+        });
+    }
+
+    GIVEN("length prefixed frames") {
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            co_await writing.write("\x03" "abc" "\x05" "de"sv);
+            StreamReader reader{reading};
+            auto header = co_await reader.peek(1);
+            REQUIRE(header[0] == 3);
+            reader.consume(1);
+            auto frame = co_await reader.readexactly(3);
+            REQUIRE(view(frame) == "abc");
+            header = co_await reader.readexactly(1);
+            REQUIRE(header[0] == 5);
+            co_await writing.write("fgh"sv);
+            frame = co_await reader.readexactly(5);
+            REQUIRE(view(frame) == "defgh");
+        });
+    }
+
+    GIVEN("a frame larger than the read size") {
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            std::string big(10'000, 'x');
+            co_await writing.write(big);
+            StreamReader reader{reading, 1024};
+            auto frame = co_await reader.readexactly(big.size());
+            REQUIRE(view(frame) == big);
+        });
+    }
+
+    GIVEN("a delimiter split across reads") {
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            StreamReader reader{reading, 4};
+            co_await writing.write("abc\r"sv);
+            auto data = co_await reader.peek();
+            REQUIRE(view(data) == "abc\r");
+            co_await writing.write("\nrest"sv);
+            data = co_await reader.readuntil("\r\n");
+            REQUIRE(view(data) == "abc\r\n");
+            data = co_await reader.readexactly(4);
+            REQUIRE(view(data) == "rest");
+        });
+    }
+
+    GIVEN("no delimiter within the limit") {
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            co_await writing.write("0123456789"sv);
+            StreamReader reader{reading, StreamReader::default_read_size, 8};
+            REQUIRE_THROWS_AS(co_await reader.readline(), LimitOverrunError);
+            REQUIRE(reader.buffered().size() == 10);
+        });
+    }
+
+    GIVEN("EOF before the frame is complete") {
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            co_await writing.write("abc"sv);
+            writing.close();
+            StreamReader reader{reading};
+            try {
+                co_await reader.readexactly(4);
+                FAIL("expected IncompleteReadError");
+            } catch (const IncompleteReadError& e) {
+                REQUIRE(e.partial == 3);
+                REQUIRE(e.expected == 4);
+            }
+            REQUIRE_THROWS_AS(co_await reader.readline(), IncompleteReadError);
+            auto data = co_await reader.read(100);
+            REQUIRE(view(data) == "abc");
+            data = co_await reader.read(100);
+            REQUIRE(data.empty());
+            REQUIRE(reader.at_eof());
+        });
+    }
+}
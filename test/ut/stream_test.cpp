@@ -0,0 +1,525 @@
+//
+// Created on 2026/10/18.
+//
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/gather.h>
+#include <asyncio/runner.h>
+#include <asyncio/sleep.h>
+#include <asyncio/stream.h>
+
+#include <array>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace ASYNCIO_NS;
+using namespace std::string_view_literals;
+using namespace std::chrono;
+
+namespace {
+// an unlinked temporary file holding `content`
+struct TempFile {
+    explicit TempFile(const std::string& content) {
+        char path[] = "/tmp/asyncio_ut_XXXXXX";
+        fd = ::mkstemp(path);
+        ::unlink(path);
+        REQUIRE(::write(fd, content.data(), content.size()) == ssize_t(content.size()));
+    }
+    ~TempFile() { ::close(fd); }
+    int fd;
+};
+
+// runs `body(reading, writing)` on the two ends of a socket pair
+template<typename Body>
+void with_socketpair(Body body) {
+    asyncio::run([&]() -> Task<> {
+        int fds[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+        Stream reading{fds[0]}, writing{fds[1]};
+        co_await body(reading, writing);
+    }());
+}
+
+// runs `body(reading, writing)` on the two ends of a loopback TCP connection
+template<typename Body>
+void with_tcp_pair(Body body) {
+    asyncio::run([&]() -> Task<> {
+        int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in sin{ .sin_family = AF_INET, .sin_port = 0 };
+        sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        REQUIRE(::bind(listener, reinterpret_cast<sockaddr*>(&sin), sizeof(sin)) == 0);
+        REQUIRE(::listen(listener, 1) == 0);
+        socklen_t len = sizeof(sin);
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&sin), &len);
+        int client = ::socket(AF_INET, SOCK_STREAM, 0);
+        REQUIRE(::connect(client, reinterpret_cast<sockaddr*>(&sin), sizeof(sin)) == 0);
+        ::fcntl(client, F_SETFL, ::fcntl(client, F_GETFL) | O_NONBLOCK);
+        int server = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+        ::close(listener);
+        Stream reading{server}, writing{client};
+        co_await body(reading, writing);
+    }());
+}
+}
+
+SCENARIO("Stream timeouts") {
+    GIVEN("a read timeout and a silent peer") {
+        with_socketpair([](Stream& reading, Stream& writing) -> Task<> {
+            reading.set_read_timeout(20ms);
+            std::string buf(16, '\0');
+            auto before = get_event_loop().time();
+            auto timed_out = co_await reading.try_read_in_place(std::span{buf});
+            REQUIRE(timed_out.error() == std::errc::timed_out);
+            REQUIRE(get_event_loop().time() - before >= 20ms);
+
+            bool thrown = false;
+            try {
+                co_await reading.read_in_place(std::span{buf});
+            } catch (const std::system_error& e) {
+                thrown = e.code() == std::errc::timed_out;
+            }
+            REQUIRE(thrown);
+
+            // the stream is still usable
+            co_await writing.write("late"sv);
+            auto data = co_await reading.read_in_place(std::span{buf});
+            REQUIRE(std::string_view{data.data(), data.size()} == "late");
+        });
+    }
+
+    GIVEN("a read timeout shorter than the whole exchange") {
+        with_socketpair([](Stream& reading, Stream& writing) -> Task<> {
+            reading.set_read_timeout(40ms);
+            auto sender = [&]() -> Task<> {
+                for (int i = 0; i < 8; ++i) {
+                    co_await asyncio::sleep(10ms);
+                    co_await writing.write("x"sv);
+                }
+                writing.close();
+            };
+            auto receiver = [&]() -> Task<> {
+                auto data = co_await reading.read<std::string>();
+                REQUIRE(data == "xxxxxxxx");
+            };
+            co_await asyncio::gather(sender(), receiver());
+        });
+    }
+
+    GIVEN("an idle timeout") {
+        with_socketpair([](Stream& reading, Stream& writing) -> Task<> {
+            reading.set_idle_timeout(50ms);
+            std::string buf(16, '\0');
+            auto sender = [&]() -> Task<> {
+                for (int i = 0; i < 5; ++i) {
+                    co_await asyncio::sleep(20ms);
+                    co_await writing.write("x"sv);
+                }
+            };
+            auto receiver = [&]() -> Task<> {
+                size_t received = 0;
+                while (true) {
+                    auto data = co_await reading.try_read_in_place(std::span{buf});
+                    if (! data) {
+                        REQUIRE(data.error() == std::errc::timed_out);
+                        break;
+                    }
+                    received += data->size();
+                }
+                REQUIRE(received == 5);
+            };
+            auto before = get_event_loop().time();
+            co_await asyncio::gather(sender(), receiver());
+            REQUIRE(get_event_loop().time() - before >= 150ms);
+        });
+    }
+
+    GIVEN("a write timeout and a peer that doesn't read") {
+        with_socketpair([](Stream&, Stream& writing) -> Task<> {
+            writing.set_write_timeout(20ms);
+            std::string big(16 * 1024 * 1024, 'x');
+            auto written = co_await writing.try_write(big);
+            REQUIRE(written.error() == std::errc::timed_out);
+        });
+    }
+
+    GIVEN("a timeout that was turned off") {
+        with_socketpair([](Stream& reading, Stream& writing) -> Task<> {
+            reading.set_read_timeout(10ms);
+            reading.set_read_timeout(0ms);
+            auto sender = [&]() -> Task<> {
+                co_await asyncio::sleep(30ms);
+                co_await writing.write("x"sv);
+            };
+            auto receiver = [&]() -> Task<> {
+                std::string buf(16, '\0');
+                auto data = co_await reading.try_read_in_place(std::span{buf});
+                REQUIRE(data.has_value());
+            };
+            co_await asyncio::gather(sender(), receiver());
+        });
+    }
+}
+
+SCENARIO("Stream errors without exceptions") {
+    GIVEN("a connection reset by the peer") {
+        with_tcp_pair([](Stream& reading, Stream& writing) -> Task<> {
+            linger abort{ .l_onoff = 1, .l_linger = 0 };
+            ::setsockopt(writing.get_fd(), SOL_SOCKET, SO_LINGER, &abort, sizeof(abort));
+            writing.close(); // sends a RST
+            std::string buf(16, '\0');
+            auto read = co_await reading.try_read_in_place(std::span{buf});
+            REQUIRE(read.error() == std::errc::connection_reset);
+            auto written = co_await reading.try_write("after the reset"sv);
+            REQUIRE(written.error() == std::errc::broken_pipe);
+        });
+    }
+
+    GIVEN("EOF is still a value") {
+        with_socketpair([](Stream& reading, Stream& writing) -> Task<> {
+            co_await writing.write("last words"sv);
+            writing.close();
+            std::string buf(64, '\0');
+            auto read = co_await reading.try_read_in_place(std::span{buf}, true);
+            REQUIRE(read.has_value());
+            REQUIRE(std::string_view{read->data(), read->size()} == "last words");
+            auto eof = co_await reading.try_read_in_place(std::span{buf});
+            REQUIRE(eof.has_value());
+            REQUIRE(eof->empty());
+        });
+    }
+}
+
+SCENARIO("Stream vectored reads and writes") {
+    GIVEN("a header and a body") {
+        with_socketpair([](Stream& reading, Stream& writing) -> Task<> {
+            std::string header = "HDR:";
+            std::string body = "the body";
+            std::vector<std::span<const char>> out{header, body};
+            co_await writing.write_vectored(out);
+
+            std::string header_in(header.size(), '\0');
+            std::string body_in(body.size(), '\0');
+            std::vector<std::span<char>> in{header_in, body_in};
+            size_t nread = co_await reading.read_vectored(in, true);
+            REQUIRE(nread == header.size() + body.size());
+            REQUIRE(header_in == header);
+            REQUIRE(body_in == body);
+        });
+    }
+
+    GIVEN("more buffers than IOV_MAX, some empty") {
+        std::vector<std::string> pieces;
+        std::string expected;
+        for (size_t i = 0; i < 3000; ++i) {
+            pieces.push_back(i % 7 == 0 ? std::string{} : std::to_string(i));
+            expected += pieces.back();
+        }
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            co_await writing.write_vectored(pieces);
+            writing.close();
+            // read back into single bytes, so the reads need several readv() calls too
+            std::vector<std::array<char, 1>> bytes(expected.size() + 10);
+            size_t nread = co_await reading.read_vectored(bytes, true);
+            REQUIRE(nread == expected.size());
+            std::string received;
+            for (size_t i = 0; i < nread; ++i) { received += bytes[i][0]; }
+            REQUIRE(received == expected);
+        });
+    }
+
+    GIVEN("buffers larger than the socket buffer") {
+        std::vector<std::string> pieces{std::string(3 * 1024 * 1024, 'a'), "b", std::string(2 * 1024 * 1024, 'c')};
+        std::string received;
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            auto sender = [&]() -> Task<> {
+                co_await writing.write_vectored(pieces);
+                writing.close();
+            };
+            auto receiver = [&]() -> Task<> {
+                auto data = co_await reading.read<std::string>();
+                received = std::move(data);
+            };
+            co_await asyncio::gather(sender(), receiver());
+        });
+        REQUIRE(received == pieces[0] + pieces[1] + pieces[2]);
+    }
+
+    GIVEN("a peer that went away") {
+        // rather than SIGPIPE killing the process, the write fails with EPIPE, on a socket and on a pipe alike
+        std::vector<std::string> pieces{"header", "body"};
+        auto write_error = [&](Stream& writing) -> Task<std::error_code> {
+            try {
+                co_await writing.write_vectored(pieces);
+            } catch (const std::system_error& e) {
+                co_return e.code();
+            }
+            co_return std::error_code{};
+        };
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            reading.close();
+            auto error = co_await write_error(writing);
+            REQUIRE(error == std::errc::broken_pipe);
+        });
+        asyncio::run([&]() -> Task<> {
+            int fds[2];
+            REQUIRE(::pipe2(fds, O_NONBLOCK) == 0);
+            ::close(fds[0]);
+            Stream writing{fds[1]};
+            auto error = co_await write_error(writing);
+            REQUIRE(error == std::errc::broken_pipe);
+        }());
+    }
+
+    GIVEN("a single read") {
+        with_socketpair([](Stream& reading, Stream& writing) -> Task<> {
+            co_await writing.write("abcdef"sv);
+            std::string first(4, '\0'), second(4, '\0');
+            std::vector<std::span<char>> in{first, second};
+            size_t nread = co_await reading.read_vectored(in);
+            REQUIRE(nread == 6);
+            REQUIRE(first == "abcd");
+            REQUIRE(second.substr(0, 2) == "ef");
+        });
+    }
+}
+
+SCENARIO("Stream idle waits and pooled reads") {
+    GIVEN("a reader waiting for data") {
+        with_socketpair([](Stream& reading, Stream& writing) -> Task<> {
+            auto& pool = get_buffer_pool();
+            size_t const in_use = pool.in_use();
+            auto sender = [&]() -> Task<> {
+                co_await asyncio::sleep(10ms);
+                // the reader waits without a buffer
+                REQUIRE(pool.in_use() == in_use);
+                co_await writing.write("ping"sv);
+                writing.close();
+            };
+            auto receiver = [&]() -> Task<> {
+                co_await reading.wait_readable();
+                auto data = co_await reading.read_pooled();
+                REQUIRE(std::string_view{data.data(), data.size()} == "ping");
+                REQUIRE(data.capacity() >= pool.block_size());
+                REQUIRE(pool.in_use() == in_use + 1);
+                auto eof = co_await reading.read_pooled(16);
+                REQUIRE(eof.empty());
+            };
+            co_await asyncio::gather(sender(), receiver());
+            REQUIRE(pool.in_use() == in_use);
+        });
+    }
+
+    GIVEN("a read timeout") {
+        with_socketpair([](Stream& reading, Stream&) -> Task<> {
+            reading.set_read_timeout(10ms);
+            bool thrown = false;
+            try {
+                co_await reading.wait_readable();
+            } catch (const std::system_error& e) {
+                thrown = e.code() == std::errc::timed_out;
+            }
+            REQUIRE(thrown);
+            auto timed_out = co_await reading.try_read_pooled();
+            REQUIRE(timed_out.error() == std::errc::timed_out);
+        });
+    }
+
+    GIVEN("a connection reset by the peer") {
+        with_tcp_pair([](Stream& reading, Stream& writing) -> Task<> {
+            linger abort{ .l_onoff = 1, .l_linger = 0 };
+            ::setsockopt(writing.get_fd(), SOL_SOCKET, SO_LINGER, &abort, sizeof(abort));
+            writing.close();
+            auto read = co_await reading.try_read_pooled();
+            REQUIRE(read.error() == std::errc::connection_reset);
+        });
+    }
+}
+
+SCENARIO("Stream fd passing") {
+    GIVEN("the read end of a pipe") {
+        with_socketpair([](Stream& reading, Stream& writing) -> Task<> {
+            int pipe_fds[2];
+            REQUIRE(::pipe(pipe_fds) == 0);
+            co_await writing.send_fds(std::span{pipe_fds, 1});
+            ::close(pipe_fds[0]); // only the received copy keeps the read end open
+            auto fds = co_await reading.recv_fds();
+            REQUIRE(fds.size() == 1);
+            REQUIRE(::fcntl(fds[0], F_GETFD) & FD_CLOEXEC);
+            REQUIRE(::write(pipe_fds[1], "via fd", 6) == 6);
+            char buf[16];
+            REQUIRE(::read(fds[0], buf, sizeof(buf)) == 6);
+            REQUIRE(std::string_view{buf, 6} == "via fd");
+            ::close(fds[0]);
+            ::close(pipe_fds[1]);
+        });
+    }
+
+    GIVEN("fds and data on the same stream") {
+        with_socketpair([](Stream& reading, Stream& writing) -> Task<> {
+            std::vector<int> none;
+            co_await writing.write("header"sv);
+            co_await writing.send_fds(none);
+            co_await writing.write("trailer"sv);
+            writing.close();
+            auto header = co_await reading.read<std::string>(6, true);
+            REQUIRE(header == "header");
+            auto fds = co_await reading.recv_fds();
+            REQUIRE(fds.empty());
+            auto trailer = co_await reading.read<std::string>();
+            REQUIRE(trailer == "trailer");
+            auto eof = co_await reading.recv_fds();
+            REQUIRE(eof.empty());
+        });
+    }
+
+    GIVEN("more fds than asked for") {
+        with_socketpair([](Stream& reading, Stream& writing) -> Task<> {
+            std::vector<int> fds{0, 1, 2};
+            co_await writing.send_fds(fds);
+            auto received = co_await reading.try_recv_fds(1);
+            REQUIRE(received.error() == std::errc::message_size);
+        });
+    }
+
+    GIVEN("one fd more than asked for, which fits the padding of the control buffer") {
+        with_socketpair([](Stream& reading, Stream& writing) -> Task<> {
+            int const next_fd = ::dup(0);
+            ::close(next_fd);
+            std::vector<int> fds{0, 1};
+            co_await writing.send_fds(fds);
+            auto received = co_await reading.try_recv_fds(1);
+            REQUIRE(received.error() == std::errc::message_size);
+            // and what did arrive is closed again
+            int const fd = ::dup(0);
+            ::close(fd);
+            REQUIRE(fd == next_fd);
+        });
+    }
+
+    GIVEN("no room for any fd") {
+        with_socketpair([](Stream& reading, Stream&) -> Task<> {
+            auto received = co_await reading.try_recv_fds(0);
+            REQUIRE(received.error() == std::errc::invalid_argument);
+        });
+    }
+}
+
+SCENARIO("Stream::write_zerocopy") {
+    std::string content(4 * 1024 * 1024, '\0');
+    for (size_t i = 0; i < content.size(); ++i) { content[i] = char(i * 13); }
+
+    auto send_and_receive = [&](std::string_view data, bool zerocopy) {
+        std::string received;
+        Stream::ZeroCopyStats stats;
+        with_tcp_pair([&](Stream& reading, Stream& writing) -> Task<> {
+            auto sender = [&]() -> Task<> {
+                REQUIRE(writing.set_zerocopy(zerocopy));
+                REQUIRE(writing.get_zerocopy() == zerocopy);
+                co_await writing.write_zerocopy(data);
+                stats = writing.zerocopy_stats();
+                writing.close();
+            };
+            auto receiver = [&]() -> Task<> {
+                auto data = co_await reading.read<std::string>();
+                received = std::move(data);
+            };
+            co_await asyncio::gather(sender(), receiver());
+        });
+        REQUIRE(received == data);
+        return stats;
+    };
+
+    GIVEN("a large write") {
+        auto stats = send_and_receive(content, true);
+        REQUIRE(stats.sends > 0);
+        // loopback always ends up copying, but the completions have to arrive all the same
+        REQUIRE(stats.copied > 0);
+    }
+
+    GIVEN("a write below the threshold") {
+        auto stats = send_and_receive(std::string_view{content}.substr(0, Stream::zerocopy_threshold - 1), true);
+        REQUIRE(stats.sends == 0);
+    }
+
+    GIVEN("zero-copy disabled") {
+        auto stats = send_and_receive(content, false);
+        REQUIRE(stats.sends == 0);
+    }
+
+    GIVEN("a peer that reset the connection") {
+        // without MSG_NOSIGNAL, the send would raise SIGPIPE and kill the test
+        with_tcp_pair([&](Stream& reading, Stream& writing) -> Task<> {
+            linger abort{ .l_onoff = 1, .l_linger = 0 };
+            ::setsockopt(reading.get_fd(), SOL_SOCKET, SO_LINGER, &abort, sizeof(abort));
+            reading.close(); // sends a RST
+            REQUIRE(writing.set_zerocopy(true));
+            std::error_code error;
+            // the first send may only collect the reset (ECONNRESET), the ones after it fail with EPIPE
+            for (int i = 0; i < 2; ++i) {
+                try {
+                    co_await writing.write_zerocopy(content);
+                } catch (const std::system_error& e) {
+                    error = e.code();
+                }
+            }
+            REQUIRE(error == std::errc::broken_pipe);
+        });
+    }
+
+    GIVEN("a socket that doesn't support it") {
+        with_socketpair([](Stream&, Stream& writing) -> Task<> {
+            REQUIRE_FALSE(writing.set_zerocopy(true));
+            REQUIRE_FALSE(writing.get_zerocopy());
+            co_return;
+        });
+    }
+}
+
+SCENARIO("Stream::sendfile") {
+    std::string content(3 * 1024 * 1024, '\0');
+    for (size_t i = 0; i < content.size(); ++i) { content[i] = char(i * 7); }
+    TempFile file{content};
+
+    auto send_and_receive = [&](off_t offset, size_t count) {
+        std::string received;
+        size_t sent = 0;
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            auto sender = [&]() -> Task<> {
+                sent = co_await writing.sendfile(file.fd, offset, count);
+                writing.close();
+            };
+            auto receiver = [&]() -> Task<> {
+                auto data = co_await reading.read<std::string>();
+                received = std::move(data);
+            };
+            co_await asyncio::gather(sender(), receiver());
+        });
+        REQUIRE(sent == received.size());
+        return received;
+    };
+
+    GIVEN("the whole file, larger than the socket buffer") {
+        REQUIRE(send_and_receive(0, content.size()) == content);
+    }
+
+    GIVEN("a range") {
+        REQUIRE(send_and_receive(1000, 5000) == content.substr(1000, 5000));
+    }
+
+    GIVEN("a range past the end of the file") {
+        REQUIRE(send_and_receive(content.size() - 10, 100) == content.substr(content.size() - 10));
+    }
+
+    GIVEN("the file position is left alone") {
+        send_and_receive(10, 10);
+        REQUIRE(::lseek(file.fd, 0, SEEK_CUR) == off_t(content.size()));
+    }
+}
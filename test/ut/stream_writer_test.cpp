@@ -0,0 +1,125 @@
+//
+// Created on 2026/10/18.
+//
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/gather.h>
+#include <asyncio/runner.h>
+#include <asyncio/sleep.h>
+#include <asyncio/stream_reader.h>
+#include <asyncio/stream_writer.h>
+
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <sys/socket.h>
+
+using namespace ASYNCIO_NS;
+using namespace std::chrono;
+using namespace std::string_view_literals;
+
+namespace {
+std::string_view view(std::span<const char> s) { return {s.data(), s.size()}; }
+
+// runs `body(reading, writing)` on the two ends of a socket pair
+template<typename Body>
+void with_socketpair(Body body) {
+    asyncio::run([&]() -> Task<> {
+        int fds[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+        Stream reading{fds[0]}, writing{fds[1]};
+        co_await body(reading, writing);
+    }());
+}
+}
+
+SCENARIO("buffered stream writer") {
+    GIVEN("writes of one loop tick go out with one syscall") {
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            StreamWriter writer{writing};
+            std::string_view borrowed = "borrowed\n";
+            writer.write("header\n"sv);
+            writer.write(std::vector<char>{'b', 'o', 'd', 'y', '\n'});
+            writer.write_borrowed(borrowed);
+            writer.write("trailer\n"sv);
+            REQUIRE(writer.buffered() == 29);
+            co_await writer.flush();
+            REQUIRE(writer.buffered() == 0);
+            REQUIRE(writer.stats().syscalls == 1);
+            REQUIRE(writer.stats().bytes == 29);
+
+            StreamReader reader{reading};
+            auto data = co_await reader.readexactly(29);
+            REQUIRE(view(data) == "header\nbody\nborrowed\ntrailer\n");
+        });
+    }
+
+    GIVEN("auto flush at the end of the loop tick") {
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            StreamWriter writer{writing};
+            writer.write("ping"sv);
+            auto data = co_await reading.read(100);
+            REQUIRE(std::string_view{data.data(), data.size()} == "ping");
+            REQUIRE(writer.stats().syscalls == 1);
+        });
+    }
+
+    GIVEN("no auto flush") {
+        with_socketpair([&](Stream&, Stream& writing) -> Task<> {
+            StreamWriter writer{writing, { .auto_flush = false }};
+            writer.write("ping"sv);
+            co_await asyncio::sleep(10ms);
+            REQUIRE(writer.stats().syscalls == 0);
+            co_await writer.flush();
+            REQUIRE(writer.stats().syscalls == 1);
+        });
+    }
+
+    GIVEN("drain applies backpressure") {
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            int sndbuf = 4096;
+            ::setsockopt(writing.get_fd(), SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+            StreamWriterOptions options{ .high_water = 16 * 1024, .low_water = 4 * 1024 };
+            constexpr size_t total = 1024 * 1024;
+            size_t received = 0;
+            auto producer = [&]() -> Task<> {
+                StreamWriter writer{writing, options};
+                std::vector<char> piece(8 * 1024, 'x');
+                for (size_t written = 0; written < total; written += piece.size()) {
+                    writer.write(piece);
+                    co_await writer.drain();
+                    REQUIRE(writer.buffered() <= options.high_water);
+                }
+                co_await writer.flush();
+            };
+            auto consumer = [&]() -> Task<> {
+                while (received < total) {
+                    auto data = co_await reading.read(64 * 1024);
+                    REQUIRE(! data.empty());
+                    received += data.size();
+                }
+            };
+            co_await asyncio::gather(producer(), consumer());
+            REQUIRE(received == total);
+        });
+    }
+
+    GIVEN("a peer that went away") {
+        // without MSG_NOSIGNAL, the flush would raise SIGPIPE and kill the test
+        with_socketpair([&](Stream& reading, Stream& writing) -> Task<> {
+            reading.close();
+            StreamWriter writer{writing};
+            writer.write("ping"sv);
+            bool broken_pipe = false;
+            try {
+                co_await writer.drain();
+                co_await asyncio::sleep(10ms);
+                co_await writer.drain();
+            } catch (const std::system_error& e) {
+                broken_pipe = e.code() == std::errc::broken_pipe;
+            }
+            REQUIRE(broken_pipe);
+        });
+    }
+}
@@ -0,0 +1,169 @@
+//
+// Created on 2026/10/18.
+//
+#include <catch2/catch_test_macros.hpp>
+#include <asyncio/datagram.h>
+#include <asyncio/gather.h>
+#include <asyncio/open_connection.h>
+#include <asyncio/runner.h>
+#include <asyncio/schedule_task.h>
+#include <asyncio/sleep.h>
+#include <asyncio/start_server.h>
+#include <asyncio/subprocess.h>
+
+#include <fmt/core.h>
+
+#include <filesystem>
+#include <set>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <signal.h>
+
+using namespace ASYNCIO_NS;
+using namespace std::chrono;
+
+SCENARIO("subprocesses") {
+    GIVEN("a filter") {
+        asyncio::run([]() -> Task<> {
+            auto cat = create_subprocess_exec("cat");
+            REQUIRE(cat.stdin_pipe);
+            REQUIRE(cat.stdout_pipe);
+            REQUIRE_FALSE(cat.stderr_pipe);
+            std::string input(1024 * 1024, 'x'); // more than fits in the pipes
+            auto [out, err] = co_await cat.communicate(input);
+            REQUIRE(out == input);
+            REQUIRE(err.empty());
+            REQUIRE(cat.returncode() == 0);
+        }());
+    }
+
+    GIVEN("a child that stops reading its input") {
+        asyncio::run([]() -> Task<> {
+            auto head = create_subprocess_exec("head", {"-c1"});
+            std::string input(1024 * 1024, 'y'); // more than fits in the pipe, so the write outlives the child
+            auto [out, err] = co_await head.communicate(input);
+            REQUIRE(out == "y");
+            REQUIRE(head.returncode() == 0);
+
+            // and writing to its stdin now fails, rather than raising SIGPIPE
+            auto again = create_subprocess_exec("head", {"-c1"});
+            co_await again.stdin_pipe->write(std::string_view{"z"});
+            auto first = co_await again.stdout_pipe->read<std::string>();
+            REQUIRE(first == "z");
+            co_await again.wait();
+            auto written = co_await again.stdin_pipe->try_write(input);
+            REQUIRE(written.error() == std::errc::broken_pipe);
+            sigset_t pending;
+            ::sigpending(&pending);
+            REQUIRE_FALSE(sigismember(&pending, SIGPIPE));
+        }());
+    }
+
+    GIVEN("exit codes and signals") {
+        asyncio::run([]() -> Task<> {
+            SubprocessOptions const quiet{ .stdin_to = SubprocessOptions::Redirect::devnull,
+                                           .stdout_to = SubprocessOptions::Redirect::devnull };
+            auto failing = create_subprocess_exec("sh", {"-c", "exit 3"}, quiet);
+            auto code = co_await failing.wait();
+            REQUIRE(code == 3);
+
+            auto sleeper = create_subprocess_exec("sleep", {"10"}, quiet);
+            sleeper.kill();
+            auto killed = co_await sleeper.wait();
+            REQUIRE(killed == -SIGKILL);
+            auto again = co_await sleeper.wait();
+            REQUIRE(again == -SIGKILL);
+        }());
+    }
+
+    GIVEN("several coroutines waiting for the same child") {
+        asyncio::run([]() -> Task<> {
+            SubprocessOptions const quiet{ .stdin_to = SubprocessOptions::Redirect::devnull,
+                                           .stdout_to = SubprocessOptions::Redirect::devnull };
+            auto child = create_subprocess_exec("sh", {"-c", "sleep 0.05; exit 7"}, quiet);
+            // the first one watches the process, then goes away, and one of the others takes over
+            auto abandoned = schedule_task(child.wait());
+            co_await asyncio::sleep(1ms);
+            auto abandon = [&]() -> Task<> {
+                co_await asyncio::sleep(10ms);
+                abandoned.cancel();
+            };
+            auto&& [first, second, _] = co_await asyncio::gather(child.wait(), child.wait(), abandon());
+            REQUIRE(first == 7);
+            REQUIRE(second == 7);
+            REQUIRE(child.returncode() == 7);
+        }());
+    }
+
+    GIVEN("a slow child, while the loop goes on") {
+        asyncio::run([]() -> Task<> {
+            SubprocessOptions const options{ .stderr_to = SubprocessOptions::Redirect::pipe,
+                                             .env = std::vector<std::string>{"GREETING=hello"} };
+            auto child = create_subprocess_exec("sh", {"-c", "sleep 0.05; echo $GREETING; echo oops >&2"}, options);
+            size_t ticks = 0;
+            bool exited = false;
+            auto ticker = [&]() -> Task<> {
+                while (! exited) {
+                    co_await asyncio::sleep(1ms);
+                    ++ticks;
+                }
+            };
+            auto reader = [&]() -> Task<> {
+                auto out = co_await child.stdout_pipe->read<std::string>();
+                auto err = co_await child.stderr_pipe->read<std::string>();
+                REQUIRE(out == "hello\n");
+                REQUIRE(err == "oops\n");
+                auto code = co_await child.wait();
+                REQUIRE(code == 0);
+                exited = true;
+            };
+            co_await asyncio::gather(ticker(), reader());
+            REQUIRE(ticks > 0); // the loop went on while the child ran
+        }());
+    }
+
+    GIVEN("sockets open while spawning") {
+        asyncio::run([]() -> Task<> {
+            int accepted = -1;
+            bool spawned = false;
+            auto handle = [&](Stream stream) -> Task<> {
+                accepted = stream.get_fd();
+                while (! spawned) { co_await asyncio::sleep(1ms); }
+            };
+            auto server = co_await asyncio::start_server(handle, "127.0.0.1", 8892);
+            auto serving = schedule_task(server.serve_forever());
+            auto client = co_await asyncio::open_connection("127.0.0.1", 8892);
+            auto endpoint = co_await create_datagram_endpoint("127.0.0.1", 0);
+            while (accepted == -1) { co_await asyncio::sleep(1ms); }
+            for (int fd : {accepted, client.get_fd(), endpoint.get_fd(), get_event_loop().get_fd()}) {
+                REQUIRE(::fcntl(fd, F_GETFD) & FD_CLOEXEC);
+            }
+
+            auto child = create_subprocess_exec("cat");
+            // echoed: the exec is through, including the closing of close-on-exec fds
+            co_await child.stdin_pipe->write(std::string_view{"x"});
+            auto echo = co_await child.stdout_pipe->read<std::string>(1, true);
+            REQUIRE(echo == "x");
+            std::set<std::string> inherited;
+            for (auto& entry : std::filesystem::directory_iterator(fmt::format("/proc/{}/fd", child.pid()))) {
+                inherited.insert(entry.path().filename().string());
+            }
+            spawned = true;
+            co_await child.communicate();
+            REQUIRE(inherited == std::set<std::string>{"0", "1", "2"});
+            serving.cancel();
+        }());
+    }
+
+    GIVEN("a program that doesn't exist") {
+        bool thrown = false;
+        try {
+            auto child = create_subprocess_exec("/nonexistent/program");
+        } catch (const std::system_error& e) {
+            thrown = e.code() == std::errc::no_such_file_or_directory;
+        }
+        REQUIRE(thrown);
+    }
+}
@@ -255,6 +255,19 @@ SCENARIO("test gather") {
        }()), std::overflow_error);
        REQUIRE(is_called);
    }
+
+   SECTION("test exception gather, with a task finishing before gather resumes") {
+       // the tasks start last to first, so fail() throws before succeed() returns
+       auto succeed = []() -> Task<std::string> { co_return std::string(64, 'x'); };
+       auto fail = []() -> Task<> {
+           throw std::overflow_error("failed first");
+           co_return;
+       };
+       REQUIRE_THROWS_AS(asyncio::run([&]() -> Task<> {
+           auto&& [s, _void] = co_await asyncio::gather(succeed(), fail());
+           REQUIRE(s.empty());
+       }()), std::overflow_error);
+   }
 }
 
 SCENARIO("test sleep") {
@@ -366,6 +379,17 @@ SCENARIO("test timeout") {
         REQUIRE(is_called);
     }
 
+    SECTION("try_wait_for") {
+        asyncio::run([&]() -> Task<> {
+            auto in_time = co_await try_wait_for(wait_duration(10ms), 50ms);
+            REQUIRE(in_time.has_value());
+            REQUIRE(*in_time == 0xbabababc);
+            auto timed_out = co_await try_wait_for(sleep(50ms), 10ms);
+            REQUIRE(timed_out.error() == std::errc::timed_out);
+        }());
+        REQUIRE(is_called);
+    }
+
     SECTION("wait_for with gather") {
         REQUIRE(! is_called);
         asyncio::run([&]() -> Task<> {